@@ -0,0 +1,133 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "benchmarks/bench.hpp"
+#include "taskflow/taskflow.hpp"
+
+/*
+并行算法微基准，Worker数从1翻倍到--max_threads（默认128），ns/op为每个元素的耗时
+（1）for_each_index uniform：每个元素开销相同，比较三种Partitioner的调度开销
+（2）for_each_index skewed：第i个元素的开销与i成正比，比较负载均衡
+（3）reduce：kElements个元素求和
+（4）sort：kSortElements个随机整数
+（5）pipeline：SERIAL -> PARALLEL -> SERIAL三个空pipe，line数等于Worker数，ns/op为每个token的耗时
+建议以 bazel run -c opt 运行
+*/
+
+namespace {
+
+constexpr size_t kElements = 1 << 20;
+constexpr size_t kSkewed = 1 << 12;
+constexpr size_t kSortElements = 1 << 20;
+constexpr size_t kTokens = 1 << 16;
+constexpr size_t kRuns = 8;
+
+template <typename P>
+void BenchUniform(const char *name, size_t num_workers, P part) {
+  ::shanzhai_tf::Executor executor(num_workers);
+  ::shanzhai_tf::Taskflow taskflow;
+  std::vector<double> data(kElements, 1.0);
+  taskflow.for_each_index(size_t{0}, kElements, size_t{1}, [&](size_t i) { data[i] = data[i] * 1.000001 + 1.0; },
+                          part);
+  double ns = ::shanzhai_tf::bench::RunThreads(1, [&](size_t) { executor.run_n(taskflow, kRuns).wait(); });
+  ::shanzhai_tf::bench::Report(name, num_workers, kElements * kRuns, ns);
+}
+
+template <typename P>
+void BenchSkewed(const char *name, size_t num_workers, P part) {
+  ::shanzhai_tf::Executor executor(num_workers);
+  ::shanzhai_tf::Taskflow taskflow;
+  std::vector<double> data(kSkewed, 0.0);
+  taskflow.for_each_index(
+      size_t{0}, kSkewed, size_t{1},
+      [&](size_t i) {
+        double v = 0.0;
+        for (size_t j = 0; j < i; j++) {
+          v += std::sqrt(static_cast<double>(j));
+        }
+        data[i] = v;
+      },
+      part);
+  double ns = ::shanzhai_tf::bench::RunThreads(1, [&](size_t) { executor.run_n(taskflow, kRuns).wait(); });
+  ::shanzhai_tf::bench::Report(name, num_workers, kSkewed * kRuns, ns);
+}
+
+void BenchReduce(size_t num_workers) {
+  ::shanzhai_tf::Executor executor(num_workers);
+  ::shanzhai_tf::Taskflow taskflow;
+  std::vector<long> data(kElements, 1);
+  long sum = 0;
+  taskflow.reduce(data.begin(), data.end(), sum, [](long a, long b) { return a + b; });
+  double ns = ::shanzhai_tf::bench::RunThreads(1, [&](size_t) { executor.run_n(taskflow, kRuns).wait(); });
+  ::shanzhai_tf::bench::Report("reduce", num_workers, kElements * kRuns, ns);
+}
+
+void BenchSort(size_t num_workers) {
+  ::shanzhai_tf::Executor executor(num_workers);
+  ::shanzhai_tf::Taskflow taskflow;
+  std::vector<int> data(kSortElements);
+  std::vector<int> origin(kSortElements);
+  std::mt19937 rdgen(kSortElements);
+  for (auto &v : origin) {
+    v = static_cast<int>(rdgen());
+  }
+  taskflow.sort(data.begin(), data.end());
+  double ns = 0.0;
+  for (size_t r = 0; r < kRuns; r++) {
+    std::copy(origin.begin(), origin.end(), data.begin());
+    ns += ::shanzhai_tf::bench::RunThreads(1, [&](size_t) { executor.run(taskflow).wait(); });
+  }
+  ::shanzhai_tf::bench::Report("sort", num_workers, kSortElements * kRuns, ns);
+}
+
+void BenchPipeline(size_t num_workers) {
+  ::shanzhai_tf::Executor executor(num_workers);
+  ::shanzhai_tf::Taskflow taskflow;
+  ::shanzhai_tf::Pipeline pipeline(
+      num_workers, ::shanzhai_tf::Pipe{::shanzhai_tf::PipeType::SERIAL,
+                                       [](::shanzhai_tf::Pipeflow &pf) {
+                                         if (pf.token() == kTokens) {
+                                           pf.stop();
+                                         }
+                                       }},
+      ::shanzhai_tf::Pipe{::shanzhai_tf::PipeType::PARALLEL, [](::shanzhai_tf::Pipeflow &) {}},
+      ::shanzhai_tf::Pipe{::shanzhai_tf::PipeType::SERIAL, [](::shanzhai_tf::Pipeflow &) {}});
+  taskflow.composed_of(pipeline);
+  double ns = ::shanzhai_tf::bench::RunThreads(1, [&](size_t) { executor.run_n(taskflow, kRuns).wait(); });
+  ::shanzhai_tf::bench::Report("pipeline", num_workers, kTokens * kRuns, ns);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  auto counts = ::shanzhai_tf::bench::ThreadCounts(::shanzhai_tf::bench::ParseMaxThreads(argc, argv, 128));
+  ::shanzhai_tf::bench::PrintHeader();
+  for (auto n : counts) {
+    BenchUniform("for_each_index uniform static", n, ::shanzhai_tf::StaticPartitioner());
+    BenchUniform("for_each_index uniform guided", n, ::shanzhai_tf::GuidedPartitioner());
+    BenchUniform("for_each_index uniform dynamic", n, ::shanzhai_tf::DynamicPartitioner(64));
+  }
+  for (auto n : counts) {
+    BenchSkewed("for_each_index skewed static", n, ::shanzhai_tf::StaticPartitioner());
+    BenchSkewed("for_each_index skewed guided", n, ::shanzhai_tf::GuidedPartitioner());
+    BenchSkewed("for_each_index skewed dynamic", n, ::shanzhai_tf::DynamicPartitioner());
+  }
+  for (auto n : counts) {
+    BenchReduce(n);
+  }
+  for (auto n : counts) {
+    BenchSort(n);
+  }
+  for (auto n : counts) {
+    BenchPipeline(n);
+  }
+  return 0;
+}
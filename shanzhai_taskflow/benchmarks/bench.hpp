@@ -0,0 +1,92 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace shanzhai_tf {
+namespace bench {
+
+/*
+简单的多线程计时工具
+所有线程就绪后同时开始执行f(tid)，返回从开始到最后一个线程结束的耗时（纳秒）
+*/
+template <typename F>
+double RunThreads(size_t num_threads, F &&f) {
+  std::atomic<size_t> ready{0};
+  std::atomic<bool> start{false};
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (size_t tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid]() {
+      ready.fetch_add(1, std::memory_order_relaxed);
+      while (!start.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+      }
+      f(tid);
+    });
+  }
+  while (ready.load(std::memory_order_relaxed) != num_threads) {
+    std::this_thread::yield();
+  }
+  auto beg = std::chrono::steady_clock::now();
+  start.store(true, std::memory_order_release);
+  for (auto &t : threads) {
+    t.join();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - beg).count());
+}
+
+// 线程数序列：1, 2, 4, ... 直到max_threads（包含max_threads本身）
+inline std::vector<size_t> ThreadCounts(size_t max_threads) {
+  std::vector<size_t> counts;
+  for (size_t n = 1; n < max_threads; n *= 2) {
+    counts.push_back(n);
+  }
+  counts.push_back(max_threads);
+  return counts;
+}
+
+inline size_t MaxThreads() {
+  size_t n = std::thread::hardware_concurrency();
+  return n == 0 ? 1 : n;
+}
+
+// 解析 --name=N，未指定或者不是正数时返回default_value
+inline size_t ParseSizeFlag(int argc, char **argv, const char *name, size_t default_value) {
+  const size_t len = std::strlen(name);
+  for (int i = 1; i < argc; i++) {
+    if (std::strncmp(argv[i], "--", 2) == 0 && std::strncmp(argv[i] + 2, name, len) == 0 && argv[i][2 + len] == '=') {
+      long long n = std::atoll(argv[i] + 3 + len);
+      return n > 0 ? static_cast<size_t>(n) : default_value;
+    }
+  }
+  return default_value;
+}
+
+// 解析 --max_threads=N，未指定时返回default_max
+inline size_t ParseMaxThreads(int argc, char **argv, size_t default_max) {
+  return ParseSizeFlag(argc, argv, "max_threads", default_max);
+}
+
+inline void PrintHeader() { std::printf("%-40s %8s %14s %12s\n", "case", "threads", "ops", "ns/op"); }
+
+inline void Report(const char *name, size_t threads, size_t ops, double ns) {
+  std::printf("%-40s %8zu %14zu %12.2f\n", name, threads, ops, ops == 0 ? 0.0 : ns / static_cast<double>(ops));
+  std::fflush(stdout);
+}
+
+}  // namespace bench
+}  // namespace shanzhai_tf
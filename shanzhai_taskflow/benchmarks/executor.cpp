@@ -0,0 +1,151 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include "benchmarks/bench.hpp"
+#include "taskflow/taskflow.hpp"
+
+/*
+Executor微基准，Worker数从1翻倍到--max_threads（默认128）
+（1）submit：外部线程提交空任务后wait_for_all
+   async：外部线程提交空任务，再依次get所有AsyncFuture
+（2）wide graph：1个源Task指向kWide个Task，再汇聚到1个Task，重复运行kRuns次
+（3）linear chain：kChain个Task串成一条链，重复运行kRuns次
+（4）condition loop：body -> cond -> body构成的环迭代kLoops次，ns/op为每轮迭代（两个Task）的耗时
+（5）priority latency：先提交kBatch个LOW任务，再提交一个HIGH或LOW任务，ns/op为后者从提交到完成的耗时
+建议以 bazel run -c opt 运行
+*/
+
+namespace {
+
+constexpr size_t kSubmits = 1 << 17;
+constexpr size_t kWide = 1 << 12;
+constexpr size_t kChain = 1 << 12;
+constexpr size_t kLoops = 1 << 16;
+constexpr size_t kBatch = 1 << 14;
+constexpr size_t kRuns = 16;
+
+void BenchSubmit(size_t num_workers) {
+  ::shanzhai_tf::Executor executor(num_workers);
+  std::atomic<size_t> counter{0};
+  double ns = ::shanzhai_tf::bench::RunThreads(1, [&](size_t) {
+    for (size_t i = 0; i < kSubmits; i++) {
+      executor.submit([&]() { counter.fetch_add(1, std::memory_order_relaxed); });
+    }
+    executor.wait_for_all();
+  });
+  ::shanzhai_tf::bench::Report("executor submit", num_workers, kSubmits, ns);
+}
+
+void BenchAsync(size_t num_workers) {
+  ::shanzhai_tf::Executor executor(num_workers);
+  std::vector<::shanzhai_tf::AsyncFuture<size_t>> futures(kSubmits);
+  double ns = ::shanzhai_tf::bench::RunThreads(1, [&](size_t) {
+    for (size_t i = 0; i < kSubmits; i++) {
+      futures[i] = executor.async([i]() { return i; });
+    }
+    for (auto &fu : futures) {
+      fu.get();
+    }
+  });
+  ::shanzhai_tf::bench::Report("executor async", num_workers, kSubmits, ns);
+}
+
+void BenchWideGraph(size_t num_workers) {
+  ::shanzhai_tf::Executor executor(num_workers);
+  ::shanzhai_tf::Taskflow taskflow;
+  std::atomic<size_t> counter{0};
+  auto src = taskflow.emplace([]() {});
+  auto dst = taskflow.emplace([]() {});
+  for (size_t i = 0; i < kWide; i++) {
+    auto task = taskflow.emplace([&]() { counter.fetch_add(1, std::memory_order_relaxed); });
+    src.precede(task);
+    task.precede(dst);
+  }
+  double ns = ::shanzhai_tf::bench::RunThreads(1, [&](size_t) { executor.run_n(taskflow, kRuns).wait(); });
+  ::shanzhai_tf::bench::Report("executor wide graph", num_workers, (kWide + 2) * kRuns, ns);
+}
+
+void BenchLinearChain(size_t num_workers) {
+  ::shanzhai_tf::Executor executor(num_workers);
+  ::shanzhai_tf::Taskflow taskflow;
+  std::atomic<size_t> counter{0};
+  auto prev = taskflow.emplace([&]() { counter.fetch_add(1, std::memory_order_relaxed); });
+  for (size_t i = 1; i < kChain; i++) {
+    auto curr = taskflow.emplace([&]() { counter.fetch_add(1, std::memory_order_relaxed); });
+    prev.precede(curr);
+    prev = curr;
+  }
+  double ns = ::shanzhai_tf::bench::RunThreads(1, [&](size_t) { executor.run_n(taskflow, kRuns).wait(); });
+  ::shanzhai_tf::bench::Report("executor linear chain", num_workers, kChain * kRuns, ns);
+}
+
+void BenchConditionLoop(size_t num_workers) {
+  ::shanzhai_tf::Executor executor(num_workers);
+  ::shanzhai_tf::Taskflow taskflow;
+  size_t iter = 0;
+  auto init = taskflow.emplace([&]() { iter = 0; });
+  auto body = taskflow.emplace([&]() { iter++; });
+  auto cond = taskflow.emplace([&]() -> int { return iter < kLoops ? 0 : 1; });
+  auto done = taskflow.placeholder();
+  init.precede(body);
+  body.precede(cond);
+  cond.precede(body, done);
+  double ns = ::shanzhai_tf::bench::RunThreads(1, [&](size_t) { executor.run_n(taskflow, kRuns).wait(); });
+  ::shanzhai_tf::bench::Report("executor condition loop", num_workers, kLoops * kRuns, ns);
+}
+
+void BenchPriorityLatency(const char *name, size_t num_workers, ::shanzhai_tf::TaskPriority priority) {
+  ::shanzhai_tf::Executor executor(num_workers);
+  std::atomic<size_t> sink{0};
+  for (size_t i = 0; i < kBatch; i++) {
+    executor.silent_async(
+        [&sink]() {
+          size_t v = 0;
+          for (size_t j = 0; j < 1000; j++) {
+            v += j * j;
+          }
+          sink.fetch_add(v, std::memory_order_relaxed);
+        },
+        ::shanzhai_tf::TaskPriority::LOW);
+  }
+  auto beg = std::chrono::steady_clock::now();
+  auto fu = executor.async([]() { return std::chrono::steady_clock::now(); }, priority);
+  auto end = fu.get();
+  executor.wait_for_all();
+  double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - beg).count());
+  ::shanzhai_tf::bench::Report(name, num_workers, 1, ns);
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  auto counts = ::shanzhai_tf::bench::ThreadCounts(::shanzhai_tf::bench::ParseMaxThreads(argc, argv, 128));
+  ::shanzhai_tf::bench::PrintHeader();
+  for (auto n : counts) {
+    BenchSubmit(n);
+  }
+  for (auto n : counts) {
+    BenchAsync(n);
+  }
+  for (auto n : counts) {
+    BenchWideGraph(n);
+  }
+  for (auto n : counts) {
+    BenchLinearChain(n);
+  }
+  for (auto n : counts) {
+    BenchConditionLoop(n);
+  }
+  for (auto n : counts) {
+    BenchPriorityLatency("executor priority latency high", n, ::shanzhai_tf::TaskPriority::HIGH);
+    BenchPriorityLatency("executor priority latency low", n, ::shanzhai_tf::TaskPriority::LOW);
+  }
+  return 0;
+}
@@ -0,0 +1,234 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "benchmarks/stress.hpp"
+#include "taskflow/taskflow.hpp"
+
+/*
+Executor场景：外部线程在Worker大多已经挂起时按轮提交任务，提交之后不再做任何唤醒，
+等待本轮的任务在timeout_ms内全部完成，完不成说明Worker挂起时丢失了唤醒
+（1）每轮随机选择silent_async（其中一半任务在Worker内部再提交一个子任务）、async并等待AsyncFuture、
+   同时运行多次同一个Taskflow（随机cancel其中一部分）
+（2）任务内部同样由Fuzzer插入扰动，Taskflow中包含Subflow，覆盖NotifyWaiter唤醒join所在Worker的路径；
+   源点获取、汇点归还同一个Semaphore，同时运行的多次之间互相等待，被取消的运行结束后不能遗留获取的数量
+（3）executor_nested_join场景：两层Subflow各自显式join，外部线程同时不停地提交silent_async（NORMAL与HIGH）
+   以及多个源点的Taskflow，Notify(false)/NotifyHigh/NotifyN的弹栈与最后一个子任务对joiner的NotifyWaiter交错；
+   每轮运行开始后随机一段时间停止提交，之后没有其他通知掩盖，join所在的Worker没有被唤醒时本轮的运行不会完成
+*/
+
+namespace shanzhai_tf {
+namespace stress {
+
+void RunExecutorStress(const Options &opt, uint64_t seed) {
+  const char *scenario = "executor";
+  Executor executor(opt.workers_, WorkerAffinity::none());
+  std::atomic<size_t> done{0};
+  Semaphore semaphore(2);
+
+  Taskflow taskflow;
+  auto a = taskflow.emplace([&]() { done.fetch_add(1, std::memory_order_relaxed); });
+  auto b = taskflow.emplace([&](Subflow &sf) {
+    for (int i = 0; i < 4; i++) {
+      sf.emplace([&, i]() {
+        Fuzzer(seed, static_cast<uint64_t>(i)).Point();
+        done.fetch_add(1, std::memory_order_relaxed);
+      });
+    }
+  });
+  auto c = taskflow.emplace([&]() { done.fetch_add(1, std::memory_order_relaxed); });
+  auto d = taskflow.emplace([&]() { done.fetch_add(1, std::memory_order_relaxed); });
+  a.precede(b, c);
+  d.succeed(b, c);
+  a.acquire(semaphore);
+  d.release(semaphore);
+
+  Fuzzer fuzzer(seed, 0);
+  size_t expected = 0;
+  size_t ops = 0;
+  for (size_t round = 0; round < opt.rounds_; round++) {
+    // 给Worker时间挂起，之后的提交需要真正唤醒它们
+    fuzzer.Point();
+    if (fuzzer.Next(4) == 0) {
+      std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+    const size_t k = 1 + fuzzer.Next(2 * opt.workers_);
+    ops += k;
+    switch (fuzzer.Next(3)) {
+      case 0: {
+        for (size_t i = 0; i < k; i++) {
+          const bool spawn = fuzzer.Next(2) == 0;
+          expected += spawn ? 2 : 1;
+          const uint64_t stream = (round << 20) + i;
+          executor.silent_async([&, spawn, stream]() {
+            Fuzzer(seed, stream).Point();
+            if (spawn) {
+              executor.silent_async([&]() { done.fetch_add(1, std::memory_order_relaxed); });
+            }
+            done.fetch_add(1, std::memory_order_relaxed);
+          });
+        }
+        const size_t target = expected;
+        if (!WaitUntil([&]() { return done.load(std::memory_order_relaxed) >= target; }, opt.timeout_ms_)) {
+          Fail(scenario, seed, round, "silent_async tasks did not finish (lost wakeup)");
+        }
+        break;
+      }
+      case 1: {
+        std::vector<AsyncFuture<size_t>> futures;
+        futures.reserve(k);
+        for (size_t i = 0; i < k; i++) {
+          const uint64_t stream = (round << 20) + i;
+          futures.push_back(executor.async([&, i, stream]() {
+            Fuzzer(seed, stream).Point();
+            return i;
+          }));
+        }
+        auto all_ready = [&]() {
+          for (auto &f : futures) {
+            if (!f.ready()) {
+              return false;
+            }
+          }
+          return true;
+        };
+        if (!WaitUntil(all_ready, opt.timeout_ms_)) {
+          Fail(scenario, seed, round, "async futures did not become ready (lost wakeup)");
+        }
+        for (size_t i = 0; i < k; i++) {
+          if (futures[i].get() != i) {
+            Fail(scenario, seed, round, "async returned a wrong value");
+          }
+        }
+        break;
+      }
+      default: {
+        std::vector<RunFuture> runs;
+        runs.reserve(k);
+        for (size_t i = 0; i < k; i++) {
+          runs.push_back(executor.run(taskflow));
+        }
+        for (auto &run : runs) {
+          if (fuzzer.Next(4) == 0) {
+            run.cancel();
+          }
+        }
+        auto all_ready = [&]() {
+          for (auto &run : runs) {
+            if (!run.ready()) {
+              return false;
+            }
+          }
+          return true;
+        };
+        if (!WaitUntil(all_ready, opt.timeout_ms_)) {
+          Fail(scenario, seed, round, "taskflow runs did not finish (lost wakeup)");
+        }
+        // 被取消的运行只执行了一部分任务，之后以done的当前值为准
+        expected = done.load(std::memory_order_relaxed);
+        break;
+      }
+    }
+  }
+  executor.wait_for_all();
+  if (done.load() != expected) {
+    Fail(scenario, seed, opt.rounds_, "task count does not match");
+  }
+  if (semaphore.value() != semaphore.max_value()) {
+    Fail(scenario, seed, opt.rounds_, "cancelled runs left the Semaphore acquired");
+  }
+  Pass(scenario, seed, opt.workers_, ops);
+}
+
+void RunNestedJoinStress(const Options &opt, uint64_t seed) {
+  const char *scenario = "executor_nested_join";
+  constexpr size_t kFanout = 4;
+  constexpr size_t kLeaves = 8;
+  Executor executor(opt.workers_, WorkerAffinity::none());
+  std::atomic<size_t> done{0};
+  std::atomic<uint64_t> streams{0};
+
+  Taskflow taskflow;
+  taskflow.emplace([&](Subflow &outer) {
+    for (size_t i = 0; i < kFanout; i++) {
+      outer.emplace([&](Subflow &inner) {
+        for (size_t j = 0; j < kLeaves; j++) {
+          inner.emplace([&]() {
+            // 偶尔执行得久一些，让join所在的Worker连续窃取失败后真正挂起
+            Fuzzer leaf(seed, streams.fetch_add(1, std::memory_order_relaxed));
+            leaf.Point();
+            if (leaf.Next(8) == 0) {
+              std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            }
+            done.fetch_add(1, std::memory_order_relaxed);
+          });
+        }
+        inner.join();
+      });
+    }
+    outer.join();
+  });
+
+  // 4个源点，每次运行入队时走NotifyN
+  Taskflow fan;
+  std::atomic<size_t> flood_done{0};
+  for (int i = 0; i < 4; i++) {
+    fan.emplace([&]() { flood_done.fetch_add(1, std::memory_order_relaxed); });
+  }
+
+  std::atomic<bool> stop{false};
+  std::atomic<bool> flooding{false};
+  std::thread flood([&]() {
+    Fuzzer fuzzer(seed, 1ull << 40);
+    while (!stop.load(std::memory_order_acquire)) {
+      if (!flooding.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+        continue;
+      }
+      switch (fuzzer.Next(3)) {
+        case 0:
+          executor.silent_async([&]() { flood_done.fetch_add(1, std::memory_order_relaxed); });
+          break;
+        case 1:
+          executor.silent_async([&]() { flood_done.fetch_add(1, std::memory_order_relaxed); }, TaskPriority::HIGH);
+          break;
+        default:
+          executor.run(fan);
+          break;
+      }
+      fuzzer.Point();
+    }
+  });
+
+  Fuzzer fuzzer(seed, 0);
+  for (size_t round = 0; round < opt.rounds_; round++) {
+    fuzzer.Point();
+    const size_t before = done.load(std::memory_order_relaxed);
+    flooding.store(true, std::memory_order_release);
+    auto run = executor.run(taskflow);
+    std::this_thread::sleep_for(std::chrono::microseconds(fuzzer.Next(1000)));
+    flooding.store(false, std::memory_order_release);
+    if (!WaitUntil([&]() { return run.ready(); }, opt.timeout_ms_)) {
+      Fail(scenario, seed, round, "nested subflow join did not finish (lost joiner wakeup)");
+    }
+    if (done.load(std::memory_order_relaxed) != before + kFanout * kLeaves) {
+      Fail(scenario, seed, round, "nested subflow ran a wrong number of tasks");
+    }
+  }
+  stop.store(true, std::memory_order_release);
+  flood.join();
+  executor.wait_for_all();
+  Pass(scenario, seed, opt.workers_, opt.rounds_ * kFanout * kLeaves);
+}
+
+}  // namespace stress
+}  // namespace shanzhai_tf
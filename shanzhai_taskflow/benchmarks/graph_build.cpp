@@ -0,0 +1,87 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#include <vector>
+
+#include "benchmarks/bench.hpp"
+#include "taskflow/taskflow.hpp"
+
+/*
+图构建与销毁的开销
+（1）linear chain：1M个Node串成一条链
+（2）wide fan-out：1个源Node指向1M个Node
+（3）node new/delete vs pool：只比较Node本身的分配与释放
+每个场景运行两轮，第二轮ObjectPool中已有空闲Block
+建议以 bazel run -c opt 运行
+*/
+
+namespace {
+
+constexpr size_t kNodes = 1 << 20;
+
+void BenchLinearChain() {
+  ::shanzhai_tf::Taskflow taskflow;
+  double build = ::shanzhai_tf::bench::RunThreads(1, [&](size_t) {
+    auto prev = taskflow.emplace([]() {});
+    for (size_t i = 1; i < kNodes; i++) {
+      auto curr = taskflow.emplace([]() {});
+      prev.precede(curr);
+      prev = curr;
+    }
+  });
+  double destroy = ::shanzhai_tf::bench::RunThreads(1, [&](size_t) { taskflow.clear(); });
+  ::shanzhai_tf::bench::Report("linear chain build", 1, kNodes, build);
+  ::shanzhai_tf::bench::Report("linear chain destroy", 1, kNodes, destroy);
+}
+
+void BenchWideFanOut() {
+  ::shanzhai_tf::Taskflow taskflow;
+  double build = ::shanzhai_tf::bench::RunThreads(1, [&](size_t) {
+    auto src = taskflow.emplace([]() {});
+    for (size_t i = 1; i < kNodes; i++) {
+      src.precede(taskflow.emplace([]() {}));
+    }
+  });
+  double destroy = ::shanzhai_tf::bench::RunThreads(1, [&](size_t) { taskflow.clear(); });
+  ::shanzhai_tf::bench::Report("wide fan-out build", 1, kNodes, build);
+  ::shanzhai_tf::bench::Report("wide fan-out destroy", 1, kNodes, destroy);
+}
+
+void BenchNodeAllocation() {
+  std::vector<::shanzhai_tf::Node *> nodes(kNodes);
+  double ns = ::shanzhai_tf::bench::RunThreads(1, [&](size_t) {
+    for (auto &node : nodes) {
+      node = new ::shanzhai_tf::Node();
+    }
+    for (auto node : nodes) {
+      delete node;
+    }
+  });
+  ::shanzhai_tf::bench::Report("node new/delete", 1, kNodes, ns);
+
+  auto &pool = ::shanzhai_tf::ObjectPool<::shanzhai_tf::Node>::Instance();
+  ns = ::shanzhai_tf::bench::RunThreads(1, [&](size_t) {
+    for (auto &node : nodes) {
+      node = pool.Animate();
+    }
+    for (auto node : nodes) {
+      pool.Recycle(node);
+    }
+  });
+  ::shanzhai_tf::bench::Report("node pool animate/recycle", 1, kNodes, ns);
+}
+
+}  // namespace
+
+int main() {
+  ::shanzhai_tf::bench::PrintHeader();
+  for (int round = 0; round < 2; round++) {
+    BenchLinearChain();
+    BenchWideFanOut();
+    BenchNodeAllocation();
+  }
+  return 0;
+}
@@ -0,0 +1,273 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "benchmarks/bench.hpp"
+#include "taskflow/core/notifier.hpp"
+
+/*
+Notifier微基准，每个场景同时运行Notifier、SpinNotifier以及mutex + condition_variable实现的基准版本
+（1）ping-pong：两个线程轮流通知对方，记录单程唤醒延迟
+（2）producers/waiters：P个生产者产生令牌，M个等待者消费令牌，
+   分别用Notify(false)逐个唤醒、NotifyN按批唤醒、Notify(true)全部唤醒
+（3）prepare/cancel churn：任务始终存在，PrepareWait之后总是CancelWait
+（4）broadcast：至少一半Waiter挂起后调用Notify(true)，只记录Notify线程自身的耗时
+线程数从1翻倍到--max_threads（默认128）
+建议以 bazel run -c opt 运行
+*/
+
+namespace {
+
+/*
+mutex + condition_variable实现的两阶段等待，接口与Notifier一致
+PrepareWait把等待者挂到链表上，Notify从链表头摘下一个等待者并置位signaled_，
+CommitWait在自己的条件变量上等待signaled_；信号只会发给Notify之前已经登记的等待者，
+PrepareWait之后、CommitWait之前的Notify不会丢失
+*/
+class CondVarNotifier {
+ public:
+  struct Waiter {
+    std::condition_variable cv_;
+    std::list<Waiter *>::iterator pos_;
+    bool signaled_{false};
+  };
+
+  explicit CondVarNotifier(size_t N) : waiters_(N) {}
+
+  void PrepareWait(Waiter *w) {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    w->signaled_ = false;
+    w->pos_ = this->prewaiters_.insert(this->prewaiters_.end(), w);
+  }
+
+  void CommitWait(Waiter *w) {
+    std::unique_lock<std::mutex> lock(this->mutex_);
+    w->cv_.wait(lock, [&]() { return w->signaled_; });
+  }
+
+  void CancelWait(Waiter *w) {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    if (!w->signaled_) {
+      this->prewaiters_.erase(w->pos_);
+    }
+  }
+
+  void Notify(bool all) {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    while (!this->prewaiters_.empty()) {
+      this->Signal();
+      if (!all) {
+        break;
+      }
+    }
+  }
+
+  void NotifyN(size_t n) {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    for (size_t i = 0; i < n && !this->prewaiters_.empty(); i++) {
+      this->Signal();
+    }
+  }
+
+  Waiter *GetWaiter(size_t idx) { return &this->waiters_[idx]; }
+
+ private:
+  void Signal() {
+    auto w = this->prewaiters_.front();
+    this->prewaiters_.pop_front();
+    w->signaled_ = true;
+    w->cv_.notify_one();
+  }
+
+  std::vector<Waiter> waiters_;
+  std::list<Waiter *> prewaiters_;
+  std::mutex mutex_;
+};
+
+constexpr size_t kPingPongRounds = 20000;
+constexpr size_t kTokens = 200000;
+constexpr size_t kBatch = 8;
+constexpr size_t kChurnIterations = 1 << 18;
+constexpr size_t kBroadcastRounds = 200;
+
+template <typename N>
+void BenchPingPong(const std::string &name) {
+  N notifier(2);
+  std::atomic<size_t> turn{0};
+  double ns = ::shanzhai_tf::bench::RunThreads(2, [&](size_t tid) {
+    auto w = notifier.GetWaiter(tid);
+    for (size_t round = 0; round < kPingPongRounds; round++) {
+      size_t mine = round * 2 + tid;
+      while (turn.load(std::memory_order_acquire) != mine) {
+        notifier.PrepareWait(w);
+        if (turn.load(std::memory_order_acquire) == mine) {
+          notifier.CancelWait(w);
+          break;
+        }
+        notifier.CommitWait(w);
+      }
+      turn.store(mine + 1, std::memory_order_release);
+      notifier.Notify(false);
+    }
+  });
+  ::shanzhai_tf::bench::Report((name + " ping-pong").c_str(), 2, kPingPongRounds * 2, ns);
+}
+
+enum class WakeMode { kOne, kBatch, kAll };
+
+template <typename N>
+void BenchProducers(const std::string &name, WakeMode mode, size_t num_threads) {
+  size_t num_producers = std::max<size_t>(1, num_threads / 4);
+  size_t num_waiters = std::max<size_t>(1, num_threads - num_producers);
+  N notifier(num_waiters);
+  std::atomic<int64_t> tokens{0};
+  std::atomic<size_t> consumed{0};
+  std::atomic<bool> done{false};
+  const size_t per_producer = kTokens / num_producers / kBatch * kBatch;
+  const size_t total = per_producer * num_producers;
+
+  auto consume = [&](size_t idx) {
+    auto w = notifier.GetWaiter(idx);
+    for (;;) {
+      int64_t t = tokens.load(std::memory_order_relaxed);
+      if (t > 0 && tokens.compare_exchange_weak(t, t - 1, std::memory_order_acq_rel)) {
+        if (consumed.fetch_add(1, std::memory_order_relaxed) + 1 == total) {
+          done.store(true, std::memory_order_release);
+          notifier.Notify(true);
+        }
+        continue;
+      }
+      if (done.load(std::memory_order_acquire)) {
+        return;
+      }
+      notifier.PrepareWait(w);
+      if (tokens.load(std::memory_order_acquire) > 0 || done.load(std::memory_order_acquire)) {
+        notifier.CancelWait(w);
+        continue;
+      }
+      notifier.CommitWait(w);
+    }
+  };
+
+  auto produce = [&]() {
+    for (size_t i = 0; i < per_producer; i += kBatch) {
+      tokens.fetch_add(kBatch, std::memory_order_release);
+      switch (mode) {
+        case WakeMode::kOne:
+          for (size_t k = 0; k < kBatch; k++) {
+            notifier.Notify(false);
+          }
+          break;
+        case WakeMode::kBatch:
+          notifier.NotifyN(kBatch);
+          break;
+        case WakeMode::kAll:
+          notifier.Notify(true);
+          break;
+      }
+    }
+  };
+
+  double ns = ::shanzhai_tf::bench::RunThreads(num_producers + num_waiters, [&](size_t tid) {
+    if (tid < num_producers) {
+      produce();
+    } else {
+      consume(tid - num_producers);
+    }
+  });
+  const char *suffix = mode == WakeMode::kOne ? " notify(false)" : (mode == WakeMode::kBatch ? " notifyN" : " notify(true)");
+  ::shanzhai_tf::bench::Report((name + suffix).c_str(), num_producers + num_waiters, total, ns);
+}
+
+template <typename N>
+void BenchChurn(const std::string &name, size_t num_threads) {
+  N notifier(num_threads);
+  size_t iterations = std::max<size_t>(1024, kChurnIterations / num_threads);
+  double ns = ::shanzhai_tf::bench::RunThreads(num_threads, [&](size_t tid) {
+    auto w = notifier.GetWaiter(tid);
+    for (size_t i = 0; i < iterations; i++) {
+      notifier.PrepareWait(w);
+      notifier.CancelWait(w);
+    }
+  });
+  ::shanzhai_tf::bench::Report((name + " prepare/cancel").c_str(), num_threads, iterations * num_threads, ns);
+}
+
+template <typename N>
+void BenchBroadcast(const std::string &name, size_t num_waiters) {
+  N notifier(num_waiters);
+  std::atomic<size_t> round{0};
+  std::atomic<size_t> num_parked{0};
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < num_waiters; i++) {
+    threads.emplace_back([&, i]() {
+      auto w = notifier.GetWaiter(i);
+      for (size_t r = 1; r <= kBroadcastRounds; r++) {
+        while (round.load(std::memory_order_acquire) < r) {
+          notifier.PrepareWait(w);
+          if (round.load(std::memory_order_acquire) >= r) {
+            notifier.CancelWait(w);
+            break;
+          }
+          num_parked.fetch_add(1, std::memory_order_relaxed);
+          notifier.CommitWait(w);
+          num_parked.fetch_sub(1, std::memory_order_relaxed);
+        }
+      }
+    });
+  }
+  double ns = 0;
+  for (size_t r = 1; r <= kBroadcastRounds; r++) {
+    while (num_parked.load(std::memory_order_relaxed) < (num_waiters + 1) / 2) {
+      std::this_thread::yield();
+    }
+    round.store(r, std::memory_order_release);
+    auto start = std::chrono::steady_clock::now();
+    notifier.Notify(true);
+    ns += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+  ::shanzhai_tf::bench::Report((name + " broadcast").c_str(), num_waiters, kBroadcastRounds, ns);
+}
+
+template <typename N>
+void BenchAll(const std::string &name, const std::vector<size_t> &counts) {
+  BenchPingPong<N>(name);
+  for (auto n : counts) {
+    for (auto mode : {WakeMode::kOne, WakeMode::kBatch, WakeMode::kAll}) {
+      BenchProducers<N>(name, mode, std::max<size_t>(2, n));
+    }
+  }
+  for (auto n : counts) {
+    BenchChurn<N>(name, n);
+  }
+  for (auto n : counts) {
+    BenchBroadcast<N>(name, n);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  auto counts = ::shanzhai_tf::bench::ThreadCounts(::shanzhai_tf::bench::ParseMaxThreads(argc, argv, 128));
+  ::shanzhai_tf::bench::PrintHeader();
+  BenchAll<::shanzhai_tf::Notifier>("notifier", counts);
+  BenchAll<::shanzhai_tf::SpinNotifier>("spin notifier", counts);
+  BenchAll<CondVarNotifier>("condvar", counts);
+  return 0;
+}
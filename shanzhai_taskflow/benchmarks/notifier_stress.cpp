@@ -0,0 +1,273 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "benchmarks/stress.hpp"
+#include "taskflow/core/notifier.hpp"
+
+/*
+Notifier与Executor的并发压力测试，检查没有丢失的唤醒，发现问题时打印种子并以1退出；
+扰动只是按种子插入的yield/pause/sleep（见stress.hpp中的Fuzzer），不是relacy那样的模型检查，
+不能枚举所有交错，只是反复拉长或缩短竞争窗口
+（1）Notifier场景：p个生产者与n - p个消费者，p为1与producers，n从p + 1翻倍到threads，
+   生产者每轮发布一批令牌，随机用Notify(false)逐个、NotifyN按批或者Notify(true)唤醒，
+   之后不再通知，等待令牌在timeout_ms内被取完；消费者按PrepareWait -> 再次检查 -> CancelWait/CommitWait取令牌，
+   每一步之间由Fuzzer插入扰动。令牌没有被取完说明所有消费者都挂起了，也就是丢失了唤醒
+   1.1 timed场景中一半的CommitWait换成1~200us的CommitWaitFor，超时后从等待栈删除自己与Notify/NotifyN的弹栈频繁交错；
+       超时会掩盖丢失的唤醒，这里检查的是每次等待至多被Unpark一次（Stats::num_stray_unparks为0）以及不会卡住
+   1.2 Watchdog在生产者连续timeout_ms没有完成一轮时退出，Notify本身卡住时也能发现；
+       num_stray_unparks需要SHANZHAI_TF_ENABLE_NOTIFIER_STATS，BUILD中的两个目标都已定义
+   1.3 targeted场景在timed的基础上，消费者通过ExternalPark挂起并且偶尔报告外部事件，
+       另一个线程不停地对随机的消费者调用NotifyIndex，NotifyWaiter的RemoveWaiter与弹栈、超时删除三者交错
+   1.4 生产者结束后消费者只做不限时的等待，等到全部挂起时用CheckStack检查等待栈恰好包含每个消费者一次、
+       没有环也没有停在冻结状态；消费者退出之后再检查一次等待栈为空
+（2）Executor场景见executor_stress.cpp，与本文件一起链接，同时检查头文件可以被多个编译单元包含
+（3）可以用不同的编译选项重复运行：
+   bazel run -c opt :notifier_stress
+   bazel run -c dbg :notifier_stress_tsan -- --threads=256
+   ThreadSanitizer不支持atomic_thread_fence，-Wtsan在-Werror下会报错，notifier_stress_tsan已经带上-Wno-tsan；
+   直接给notifier_stress加--copt=-fsanitize=thread时同样需要--copt=-Wno-tsan
+   --copt=-DSHANZHAI_TF_NOTIFIER_PARK=2 切换到futex，--copt=-DSHANZHAI_TF_NOTIFIER_TREE_WAKE=0 关闭树形唤醒
+*/
+
+namespace {
+
+namespace stress = ::shanzhai_tf::stress;
+
+enum class Mode { kPlain, kTimed, kTargeted };
+
+// cv实现的ExternalPark，Wait之前按Fuzzer随机报告外部事件；Wait只由所属的消费者调用
+class StressPark : public ::shanzhai_tf::ExternalPark {
+ public:
+  StressPark(uint64_t seed, uint64_t stream) : fuzzer_(seed, stream) {}
+
+  bool Wait(const std::chrono::steady_clock::time_point *deadline) override {
+    if (this->events_.load(std::memory_order_relaxed) && this->fuzzer_.Next(8) == 0) {
+      return true;
+    }
+    std::unique_lock<std::mutex> lock(this->mutex_);
+    auto woken = [this]() { return this->woken_; };
+    if (deadline == nullptr) {
+      this->cv_.wait(lock, woken);
+    } else {
+      this->cv_.wait_until(lock, *deadline, woken);
+    }
+    this->woken_ = false;
+    return false;
+  }
+
+  void Wake() override {
+    {
+      std::lock_guard<std::mutex> lock(this->mutex_);
+      this->woken_ = true;
+    }
+    this->cv_.notify_one();
+  }
+
+  void StopEvents() { this->events_.store(false, std::memory_order_relaxed); }
+
+ private:
+  stress::Fuzzer fuzzer_;
+  std::atomic<bool> events_{true};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool woken_{false};
+};
+
+// 令牌数量大于0时减1
+bool TakeToken(std::atomic<int64_t> &tokens) {
+  int64_t n = tokens.load(std::memory_order_relaxed);
+  while (n > 0) {
+    if (tokens.compare_exchange_weak(n, n - 1, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename NotifierT>
+void RunNotifierStress(const char *scenario, const stress::Options &opt, size_t num_producers, size_t num_threads,
+                       uint64_t seed, Mode mode) {
+  const size_t num_consumers = num_threads - num_producers;
+  stress::Watchdog watchdog(scenario, seed, opt.timeout_ms_);
+  NotifierT notifier(num_consumers);
+  std::atomic<int64_t> tokens{0};
+  std::atomic<size_t> produced{0};
+  std::atomic<size_t> consumed{0};
+  std::atomic<bool> draining{false};  // 生产者已经结束，消费者只做不限时的等待
+  std::atomic<bool> stop{false};
+  std::vector<std::unique_ptr<StressPark>> parks;
+  if (mode == Mode::kTargeted) {
+    for (size_t i = 0; i < num_consumers; i++) {
+      parks.push_back(std::make_unique<StressPark>(seed, (1ull << 32) + i));
+      notifier.SetExternalPark(notifier.GetWaiter(i), parks.back().get());
+    }
+  }
+
+  std::vector<std::thread> consumers;
+  consumers.reserve(num_consumers);
+  for (size_t i = 0; i < num_consumers; i++) {
+    consumers.emplace_back([&, i]() {
+      stress::Fuzzer fuzzer(seed, num_producers + i);
+      auto *w = notifier.GetWaiter(i);
+      for (;;) {
+        if (TakeToken(tokens)) {
+          consumed.fetch_add(1, std::memory_order_relaxed);
+          fuzzer.Point();
+          continue;
+        }
+        if (stop.load(std::memory_order_acquire)) {
+          return;
+        }
+        fuzzer.Point();
+        notifier.PrepareWait(w);
+        fuzzer.Point();
+        if (tokens.load(std::memory_order_seq_cst) > 0 || stop.load(std::memory_order_seq_cst)) {
+          fuzzer.Point();
+          notifier.CancelWait(w);
+          continue;
+        }
+        fuzzer.Point();
+        if (mode != Mode::kPlain && !draining.load(std::memory_order_relaxed) && fuzzer.Next(2) == 0) {
+          notifier.CommitWaitFor(w, std::chrono::microseconds(1 + fuzzer.Next(200)));
+        } else {
+          notifier.CommitWait(w);
+        }
+      }
+    });
+  }
+
+  // 只是额外的唤醒，不替代生产者的通知
+  std::atomic<bool> stop_targets{false};
+  std::thread targeter;
+  if (mode == Mode::kTargeted) {
+    targeter = std::thread([&]() {
+      stress::Fuzzer fuzzer(seed, 1ull << 33);
+      while (!stop_targets.load(std::memory_order_relaxed)) {
+        notifier.NotifyIndex(fuzzer.Next(num_consumers));
+        fuzzer.Point();
+      }
+    });
+  }
+
+  std::vector<std::thread> producers;
+  producers.reserve(num_producers);
+  for (size_t p = 0; p < num_producers; p++) {
+    producers.emplace_back([&, p]() {
+      stress::Fuzzer fuzzer(seed, p);
+      for (size_t round = 0; round < opt.rounds_; round++) {
+        // 让消费者有机会全部挂起
+        fuzzer.Point();
+        if (fuzzer.Next(4) == 0) {
+          std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        const size_t k = 1 + fuzzer.Next(num_consumers < 64 ? num_consumers : 64);
+        const size_t target = produced.fetch_add(k, std::memory_order_relaxed) + k;
+        tokens.fetch_add(static_cast<int64_t>(k), std::memory_order_seq_cst);
+        fuzzer.Point();
+        switch (fuzzer.Next(3)) {
+          case 0:
+            for (size_t i = 0; i < k; i++) {
+              notifier.Notify(false);
+              fuzzer.Point();
+            }
+            break;
+          case 1:
+            notifier.NotifyN(k);
+            break;
+          default:
+            notifier.Notify(true);
+            break;
+        }
+        // 所有生产者都停在这里时不再有任何通知，令牌只能被已经唤醒的消费者取完；
+        // consumed单调增加，其他生产者继续发布时也不会误判
+        if (!stress::WaitUntil([&]() { return consumed.load(std::memory_order_relaxed) >= target; }, opt.timeout_ms_)) {
+          stress::Fail(scenario, seed, round, "tokens left with every consumer parked (lost wakeup)");
+        }
+        watchdog.Kick();
+      }
+    });
+  }
+
+  for (auto &t : producers) {
+    t.join();
+  }
+  if (targeter.joinable()) {
+    stop_targets.store(true, std::memory_order_relaxed);
+    targeter.join();
+  }
+  for (auto &park : parks) {
+    park->StopEvents();
+  }
+  draining.store(true, std::memory_order_relaxed);
+  // 仍在限时等待的消费者超时之后改为不限时等待，最终全部挂起；入栈过程中检查失败时重试
+  auto all_parked = [&]() {
+    for (size_t i = 0; i < num_consumers; i++) {
+      if (!notifier.IsParked(notifier.GetWaiter(i))) {
+        return false;
+      }
+    }
+    return notifier.CheckStack(num_consumers);
+  };
+  if (!stress::WaitUntil(all_parked, opt.timeout_ms_)) {
+    stress::Fail(scenario, seed, opt.rounds_, "wait stack does not hold every parked consumer exactly once");
+  }
+  stop.store(true, std::memory_order_seq_cst);
+  notifier.Notify(true);
+  for (auto &t : consumers) {
+    t.join();
+  }
+  if (!notifier.CheckStack(0)) {
+    stress::Fail(scenario, seed, opt.rounds_, "wait stack is not empty (or left frozen) after every consumer left");
+  }
+  if (consumed.load() != produced.load()) {
+    stress::Fail(scenario, seed, opt.rounds_, "consumed count does not match produced count");
+  }
+  if (notifier.Snapshot().num_stray_unparks != 0) {
+    stress::Fail(scenario, seed, opt.rounds_, "a Waiter was unparked outside the wait stack or twice in one wait");
+  }
+  stress::Pass(scenario, seed, num_threads, produced.load());
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  const stress::Options opt = stress::ParseOptions(argc, argv);
+  // 只有一个生产者时丢失的唤醒不会被其他生产者的通知掩盖，之后再用producers个生产者
+  std::vector<size_t> producer_counts{1};
+  if (opt.producers_ > 1) {
+    producer_counts.push_back(opt.producers_);
+  }
+  for (uint64_t seed = opt.seed_; seed < opt.seed_ + opt.seeds_; seed++) {
+    for (size_t p : producer_counts) {
+      // 消费者少时才会出现所有消费者同时挂起，线程数从p + 1开始翻倍
+      for (size_t n : ::shanzhai_tf::bench::ThreadCounts(opt.threads_)) {
+        if (n <= p) {
+          continue;
+        }
+        RunNotifierStress<::shanzhai_tf::Notifier>("notifier", opt, p, n, seed, Mode::kPlain);
+        RunNotifierStress<::shanzhai_tf::SpinNotifier>("spin_notifier", opt, p, n, seed, Mode::kPlain);
+        RunNotifierStress<::shanzhai_tf::WideNotifier>("wide_notifier", opt, p, n, seed, Mode::kPlain);
+        RunNotifierStress<::shanzhai_tf::Notifier>("notifier_timed", opt, p, n, seed, Mode::kTimed);
+        RunNotifierStress<::shanzhai_tf::SpinNotifier>("spin_notifier_timed", opt, p, n, seed, Mode::kTimed);
+        RunNotifierStress<::shanzhai_tf::Notifier>("notifier_targeted", opt, p, n, seed, Mode::kTargeted);
+        RunNotifierStress<::shanzhai_tf::SpinNotifier>("spin_notifier_targeted", opt, p, n, seed, Mode::kTargeted);
+      }
+    }
+    stress::RunExecutorStress(opt, seed);
+    stress::RunNestedJoinStress(opt, seed);
+  }
+  return 0;
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "benchmarks/bench.hpp"
+#include "taskflow/core/notifier.hpp"
+
+namespace shanzhai_tf {
+namespace stress {
+
+struct Options {
+  size_t threads_{1024};  // Notifier场景中的最大线程数
+  size_t producers_{2};
+  size_t workers_{16};  // Executor场景中的Worker数量
+  size_t rounds_{64};
+  size_t seeds_{4};
+  uint64_t seed_{1};
+  size_t timeout_ms_{10000};
+};
+
+// --threads --producers --workers --rounds --seeds --seed --timeout_ms
+inline Options ParseOptions(int argc, char **argv) {
+  Options opt;
+  opt.threads_ = bench::ParseSizeFlag(argc, argv, "threads", opt.threads_);
+  opt.producers_ = bench::ParseSizeFlag(argc, argv, "producers", opt.producers_);
+  opt.workers_ = bench::ParseSizeFlag(argc, argv, "workers", opt.workers_);
+  opt.rounds_ = bench::ParseSizeFlag(argc, argv, "rounds", opt.rounds_);
+  opt.seeds_ = bench::ParseSizeFlag(argc, argv, "seeds", opt.seeds_);
+  opt.seed_ = bench::ParseSizeFlag(argc, argv, "seed", opt.seed_);
+  opt.timeout_ms_ = bench::ParseSizeFlag(argc, argv, "timeout_ms", opt.timeout_ms_);
+  if (opt.producers_ >= opt.threads_) {
+    opt.producers_ = opt.threads_ > 1 ? opt.threads_ - 1 : 1;
+    opt.threads_ = opt.producers_ + 1;
+  }
+  return opt;
+}
+
+/*
+调度扰动，在协议的每一步之间按种子随机插入空操作、yield、若干次pause或者短暂sleep
+（1）相同的(seed, stream)总是产生相同的扰动序列，失败时打印种子，用--seed=S --seeds=1重放
+（2）与relacy不同，这里不接管原子操作，也不枚举交错，交错仍由OS调度决定；
+   扰动只是让PrepareWait与CommitWait之间、发布与Notify之间的窗口被反复拉长或者缩短
+*/
+class Fuzzer {
+ public:
+  Fuzzer(uint64_t seed, uint64_t stream) : rng_(seed * 0x9E3779B97F4A7C15ull + stream) {}
+
+  void Point() {
+    const uint64_t r = this->rng_() % 100;
+    if (r < 50) {
+      return;
+    }
+    if (r < 75) {
+      std::this_thread::yield();
+    } else if (r < 95) {
+      for (uint64_t i = 0, n = this->rng_() % 256; i < n; i++) {
+        CpuRelax();
+      }
+    } else {
+      std::this_thread::sleep_for(std::chrono::microseconds(1 + this->rng_() % 50));
+    }
+  }
+
+  // [0, n)中的一个数
+  size_t Next(size_t n) { return static_cast<size_t>(this->rng_() % n); }
+
+ private:
+  std::mt19937_64 rng_;
+};
+
+// 等待pred()成立，超过timeout_ms返回false；检查之间不做任何通知，不会掩盖丢失的唤醒
+template <typename P>
+bool WaitUntil(P &&pred, size_t timeout_ms) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+  while (!pred()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds(100));
+  }
+  return true;
+}
+
+// 挂起中的线程无法join，打印后直接退出进程
+[[noreturn]] inline void Fail(const char *scenario, uint64_t seed, size_t round, const char *what) {
+  std::fprintf(stderr, "FAILED %s seed=%llu round=%zu: %s\n", scenario, static_cast<unsigned long long>(seed), round,
+               what);
+  std::fflush(stderr);
+  std::_Exit(1);
+}
+
+/*
+场景运行期间的看门狗，连续timeout_ms没有Kick时打印种子并退出
+Notify等调用本身卡住（例如等待栈被破坏后一直处于冻结状态）时WaitUntil没有机会执行，由这里发现
+*/
+class Watchdog {
+ public:
+  Watchdog(const char *scenario, uint64_t seed, size_t timeout_ms)
+      : thread_([this, scenario, seed, timeout_ms]() { this->Run(scenario, seed, timeout_ms); }) {}
+
+  ~Watchdog() {
+    {
+      std::lock_guard<std::mutex> lock(this->mutex_);
+      this->done_ = true;
+    }
+    this->cv_.notify_one();
+    this->thread_.join();
+  }
+
+  Watchdog(const Watchdog &) = delete;
+  Watchdog &operator=(const Watchdog &) = delete;
+
+  void Kick() { this->progress_.fetch_add(1, std::memory_order_relaxed); }
+
+ private:
+  void Run(const char *scenario, uint64_t seed, size_t timeout_ms);
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool done_{false};
+  std::atomic<size_t> progress_{0};
+  std::thread thread_;  // 最后初始化
+};
+
+inline void Pass(const char *scenario, uint64_t seed, size_t threads, size_t ops) {
+  std::printf("%-40s seed=%-6llu threads=%-6zu ops=%zu ok\n", scenario, static_cast<unsigned long long>(seed), threads,
+              ops);
+  std::fflush(stdout);
+}
+
+inline void Watchdog::Run(const char *scenario, uint64_t seed, size_t timeout_ms) {
+  std::unique_lock<std::mutex> lock(this->mutex_);
+  size_t last = SIZE_MAX;
+  while (!this->cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this]() { return this->done_; })) {
+    const size_t progress = this->progress_.load(std::memory_order_relaxed);
+    if (progress == last) {
+      Fail(scenario, seed, progress, "no progress within timeout_ms (hang)");
+    }
+    last = progress;
+  }
+}
+
+// 定义在executor_stress.cpp
+void RunExecutorStress(const Options &opt, uint64_t seed);
+void RunNestedJoinStress(const Options &opt, uint64_t seed);
+
+}  // namespace stress
+}  // namespace shanzhai_tf
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "benchmarks/bench.hpp"
+#include "taskflow/core/tsq.hpp"
+
+/*
+工作窃取队列微基准
+（1）owner push/pop：所属线程先Push kItems个元素再全部Pop
+（2）owner push/steal：所属线程不断Push，其余线程不断Steal，直到所有元素被取走
+建议以 bazel run -c opt 运行
+*/
+
+namespace {
+
+constexpr size_t kItems = 1 << 20;
+
+// 返回为了腾出空间所属线程自己Pop的元素个数
+template <typename Q>
+size_t PushItem(Q &q, int *item) {
+  size_t popped = 0;
+  if constexpr (std::is_same_v<Q, ::shanzhai_tf::UnboundedTaskQueue<int *>>) {
+    q.Push(item);
+  } else {
+    while (!q.TryPush(item)) {
+      if (q.Pop() != nullptr) {
+        popped++;
+      }
+    }
+  }
+  return popped;
+}
+
+template <typename Q>
+void BenchOwnerPushPop(const char *name, std::vector<int> &items) {
+  auto q = std::make_unique<Q>();
+  double ns = ::shanzhai_tf::bench::RunThreads(1, [&](size_t) {
+    for (size_t r = 0; r < items.size(); r += 1024) {
+      for (size_t i = r; i < r + 1024; i++) {
+        PushItem(*q, &items[i]);
+      }
+      while (q->Pop() != nullptr) {
+      }
+    }
+  });
+  ::shanzhai_tf::bench::Report(name, 1, items.size() * 2, ns);
+}
+
+void BenchOwnerPushPopGrow(std::vector<int> &items) {
+  ::shanzhai_tf::UnboundedTaskQueue<int *> q(1);
+  double ns = ::shanzhai_tf::bench::RunThreads(1, [&](size_t) {
+    for (auto &item : items) {
+      q.Push(&item);
+    }
+    while (q.Pop() != nullptr) {
+    }
+  });
+  ::shanzhai_tf::bench::Report("unbounded push/pop (grow)", 1, items.size() * 2, ns);
+}
+
+template <typename Q>
+void BenchSteal(const char *name, size_t num_threads, std::vector<int> &items) {
+  auto q = std::make_unique<Q>();
+  std::atomic<size_t> taken{0};
+  double ns = ::shanzhai_tf::bench::RunThreads(num_threads, [&](size_t tid) {
+    if (tid == 0) {
+      for (auto &item : items) {
+        size_t popped = PushItem(*q, &item);
+        if (popped > 0) {
+          taken.fetch_add(popped, std::memory_order_relaxed);
+        }
+      }
+      // 所属线程也参与取走剩余元素
+      while (taken.load(std::memory_order_relaxed) < items.size()) {
+        if (q->Pop() != nullptr) {
+          taken.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+      return;
+    }
+    while (taken.load(std::memory_order_relaxed) < items.size()) {
+      if (q->Steal() != nullptr) {
+        taken.fetch_add(1, std::memory_order_relaxed);
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+  ::shanzhai_tf::bench::Report(name, num_threads, items.size(), ns);
+}
+
+}  // namespace
+
+int main() {
+  std::vector<int> items(kItems);
+
+  ::shanzhai_tf::bench::PrintHeader();
+  BenchOwnerPushPop<::shanzhai_tf::BoundedTaskQueue<int *>>("bounded push/pop", items);
+  BenchOwnerPushPop<::shanzhai_tf::UnboundedTaskQueue<int *>>("unbounded push/pop", items);
+  BenchOwnerPushPopGrow(items);
+  for (auto n : ::shanzhai_tf::bench::ThreadCounts(std::max<size_t>(2, ::shanzhai_tf::bench::MaxThreads()))) {
+    if (n < 2) {
+      continue;
+    }
+    BenchSteal<::shanzhai_tf::BoundedTaskQueue<int *>>("bounded push + steal", n, items);
+    BenchSteal<::shanzhai_tf::UnboundedTaskQueue<int *>>("unbounded push + steal", n, items);
+  }
+  return 0;
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "benchmarks/bench.hpp"
+#include "taskflow/core/cache_line.hpp"
+#include "taskflow/core/notifier.hpp"
+
+/*
+对比Waiter布局调整前后的伪共享开销
+（1）waiter slots：每个线程反复写自己的Waiter（模拟PrepareWait/CommitWait写epoch_、state_、next_）
+   PackedWaiter为调整前的布局，PaddedWaiter独占缓存行
+（2）state word：一个线程CAS state_，其余线程读取相邻的waiters_数据指针（CommitWait/Notify中的&waiters_[0]）
+   PackedState为调整前的布局，PaddedState中state_独占缓存行
+（3）Notifier PrepareWait/CancelWait：调整后的真实开销
+建议以 bazel run -c opt 运行
+*/
+
+namespace {
+
+constexpr size_t kIterations = 1 << 20;
+
+// 字段与调整前的Notifier::Waiter一致，改为原子变量避免写操作被编译器优化掉
+struct PackedWaiter {
+  std::atomic<PackedWaiter *> next_;
+  std::atomic<uint64_t> epoch_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::atomic<unsigned> state_;
+};
+
+struct alignas(::shanzhai_tf::kCacheLineSize) PaddedWaiter {
+  std::atomic<PaddedWaiter *> next_;
+  std::atomic<uint64_t> epoch_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::atomic<unsigned> state_;
+};
+
+struct PackedState {
+  std::atomic<void *> waiters_;
+  std::atomic<uint64_t> state_;
+};
+
+struct PaddedState {
+  std::atomic<void *> waiters_;
+  alignas(::shanzhai_tf::kCacheLineSize) std::atomic<uint64_t> state_;
+};
+
+template <typename W, typename Alloc>
+void BenchWaiterSlots(const char *name, size_t num_threads) {
+  std::vector<W, Alloc> waiters(num_threads);
+  double ns = ::shanzhai_tf::bench::RunThreads(num_threads, [&](size_t tid) {
+    W &w = waiters[tid];
+    for (size_t i = 0; i < kIterations; i++) {
+      w.epoch_.store(i, std::memory_order_relaxed);
+      w.next_.store(&w, std::memory_order_relaxed);
+      w.state_.store(static_cast<unsigned>(i), std::memory_order_release);
+    }
+  });
+  ::shanzhai_tf::bench::Report(name, num_threads, kIterations * num_threads, ns);
+}
+
+template <typename S>
+void BenchStateWord(const char *name, size_t num_threads) {
+  S s;
+  s.waiters_.store(&s, std::memory_order_relaxed);
+  s.state_.store(0, std::memory_order_relaxed);
+  std::atomic<bool> done{false};
+  double ns = ::shanzhai_tf::bench::RunThreads(num_threads, [&](size_t tid) {
+    if (tid == 0) {
+      for (size_t i = 0; i < kIterations; i++) {
+        uint64_t state = s.state_.load(std::memory_order_relaxed);
+        while (!s.state_.compare_exchange_weak(state, state + 1, std::memory_order_acq_rel)) {
+        }
+      }
+      done.store(true, std::memory_order_release);
+      return;
+    }
+    while (!done.load(std::memory_order_acquire)) {
+      for (size_t i = 0; i < 64; i++) {
+        if (s.waiters_.load(std::memory_order_relaxed) == nullptr) {
+          return;
+        }
+      }
+      std::this_thread::yield();
+    }
+  });
+  ::shanzhai_tf::bench::Report(name, num_threads, kIterations, ns);
+}
+
+void BenchNotifierChurn(size_t num_threads) {
+  ::shanzhai_tf::Notifier notifier(num_threads);
+  double ns = ::shanzhai_tf::bench::RunThreads(num_threads, [&](size_t tid) {
+    auto w = notifier.GetWaiter(tid);
+    for (size_t i = 0; i < kIterations; i++) {
+      notifier.PrepareWait(w);
+      notifier.CancelWait(w);
+    }
+  });
+  ::shanzhai_tf::bench::Report("notifier prepare/cancel", num_threads, kIterations * num_threads, ns);
+}
+
+}  // namespace
+
+int main() {
+  ::shanzhai_tf::bench::PrintHeader();
+  for (auto n : ::shanzhai_tf::bench::ThreadCounts(::shanzhai_tf::bench::MaxThreads())) {
+    BenchWaiterSlots<PackedWaiter, std::allocator<PackedWaiter>>("waiter slots packed", n);
+    BenchWaiterSlots<PaddedWaiter, ::shanzhai_tf::AlignedAllocator<PaddedWaiter>>("waiter slots padded", n);
+  }
+  for (auto n : ::shanzhai_tf::bench::ThreadCounts(std::max<size_t>(2, ::shanzhai_tf::bench::MaxThreads()))) {
+    if (n < 2) {
+      continue;
+    }
+    BenchStateWord<PackedState>("state word packed", n);
+    BenchStateWord<PaddedState>("state word padded", n);
+  }
+  for (auto n : ::shanzhai_tf::bench::ThreadCounts(::shanzhai_tf::bench::MaxThreads())) {
+    BenchNotifierChurn(n);
+  }
+  return 0;
+}
@@ -0,0 +1,62 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#include "taskflow/taskflow.hpp"
+
+#include <atomic>
+#include <cstdio>
+#include <iostream>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#endif
+
+/*
+以compact策略创建Executor，每个Worker依次绑定到一个cpu；
+WorkerInterface在Worker线程启动时设置线程名（top -H或者gdb中可见），退出时计数
+
+Output:
+started = 4
+stopped = 4
+*/
+
+namespace {
+
+class NamingWorker : public ::shanzhai_tf::WorkerInterface {
+ public:
+  void scheduler_prologue(size_t worker_id, const std::vector<int> &) override {
+#ifdef __linux__
+    char name[16];
+    std::snprintf(name, sizeof(name), "tf-worker-%zu", worker_id);
+    pthread_setname_np(pthread_self(), name);
+#endif
+    this->started_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void scheduler_epilogue(size_t) override { this->stopped_.fetch_add(1, std::memory_order_relaxed); }
+
+  int started() const { return this->started_.load(); }
+  int stopped() const { return this->stopped_.load(); }
+
+ private:
+  std::atomic<int> started_{0};
+  std::atomic<int> stopped_{0};
+};
+
+}  // namespace
+
+int main() {
+  auto wif = ::shanzhai_tf::make_worker_interface<NamingWorker>();
+  {
+    ::shanzhai_tf::Executor executor(4, ::shanzhai_tf::WorkerAffinity::compact(), wif);
+    std::cout << "started = " << wif->started() << "\n";
+    executor.async([]() {}).get();
+  }
+  std::cout << "stopped = " << wif->stopped() << "\n";
+
+  return 0;
+}
@@ -0,0 +1,55 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#include "taskflow/taskflow.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+/*
+init -> square -> reduce
+              |---> scan
+              +---> copy -> sort
+
+Output:
+sum = 332833500
+scan.back() = 332833500
+sorted = 1
+*/
+
+int main() {
+  ::shanzhai_tf::Executor executor(4);
+  ::shanzhai_tf::Taskflow taskflow;
+
+  std::vector<long> data(1000);
+  std::vector<long> squares(data.size());
+  std::vector<long> prefix(data.size());
+  std::vector<long> sorted(data.size());
+  long sum = 0;
+
+  auto init = taskflow.for_each_index(0, static_cast<int>(data.size()), 1, [&](int i) { data[i] = i; });
+  auto square = taskflow.transform(data.begin(), data.end(), squares.begin(), [](long v) { return v * v; },
+                                   ::shanzhai_tf::StaticPartitioner());
+  auto reduce = taskflow.reduce(squares.begin(), squares.end(), sum, std::plus<long>(),
+                                ::shanzhai_tf::DynamicPartitioner(64));
+  auto scan = taskflow.inclusive_scan(squares.begin(), squares.end(), prefix.begin(), std::plus<long>());
+  auto copy = taskflow.emplace([&]() { sorted.assign(squares.rbegin(), squares.rend()); });
+  auto sort = taskflow.sort(sorted.begin(), sorted.end());
+
+  init.precede(square);
+  square.precede(reduce, scan, copy);
+  copy.precede(sort);
+
+  executor.run(taskflow).wait();
+
+  std::cout << "sum = " << sum << "\n";
+  std::cout << "scan.back() = " << prefix.back() << "\n";
+  std::cout << "sorted = " << std::is_sorted(sorted.begin(), sorted.end()) << "\n";
+
+  return 0;
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#include "taskflow/taskflow.hpp"
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+/*
+A执行期间取消这次运行，A之后的100个任务都被跳过；之后再次运行同一个Taskflow，所有任务照常执行
+
+        +----+
+   +--->| B0 |---+
++---+   +----+   |   +---+
+| A |--- ...  ---+-->| C |
++---+   +----+   |   +---+
+   +--->| B99|---+
+        +----+
+
+之后4条链Ai -> Ci -> Bi共用一个Semaphore（Ai获取、Bi归还），A0执行期间取消，A1~A3挂在Semaphore上；
+C0与B0被跳过，Executor代为归还A0获取的Semaphore，A1~A3被唤醒后同样被跳过，运行正常结束
+
+Output:
+cancelled = 1
+executed = 1
+rerun executed = 102
+semaphore cancelled = 1
+semaphore value = 1
+semaphore rerun executed = 12
+*/
+
+int main() {
+  ::shanzhai_tf::Executor executor(4);
+
+  std::atomic<bool> started{false};
+  std::atomic<bool> release{false};
+  std::atomic<int> executed{0};
+  ::shanzhai_tf::Taskflow taskflow;
+  auto a = taskflow.emplace([&]() {
+    executed.fetch_add(1);
+    started.store(true);
+    while (!release.load()) {
+      std::this_thread::yield();
+    }
+  });
+  auto c = taskflow.emplace([&]() { executed.fetch_add(1); });
+  for (int i = 0; i < 100; i++) {
+    auto b = taskflow.emplace([&]() { executed.fetch_add(1); });
+    a.precede(b);
+    b.precede(c);
+  }
+
+  auto future = executor.run(taskflow);
+  while (!started.load()) {
+    std::this_thread::yield();
+  }
+  bool cancelled = future.cancel();
+  release.store(true);
+  future.wait();
+  std::cout << "cancelled = " << cancelled << "\n";
+  std::cout << "executed = " << executed.load() << "\n";
+
+  executed.store(0);
+  executor.run(taskflow).wait();
+  std::cout << "rerun executed = " << executed.load() << "\n";
+
+  ::shanzhai_tf::Semaphore semaphore(1);
+  std::atomic<bool> chain_started{false};
+  std::atomic<bool> chain_release{false};
+  std::atomic<int> chain_executed{0};
+  ::shanzhai_tf::Taskflow chains;
+  for (int i = 0; i < 4; i++) {
+    auto ai = chains
+                  .emplace([&]() {
+                    chain_executed.fetch_add(1);
+                    chain_started.store(true);
+                    while (!chain_release.load()) {
+                      std::this_thread::yield();
+                    }
+                  })
+                  .acquire(semaphore);
+    auto ci = chains.emplace([&]() { chain_executed.fetch_add(1); });
+    auto bi = chains.emplace([&]() { chain_executed.fetch_add(1); }).release(semaphore);
+    ai.precede(ci);
+    ci.precede(bi);
+  }
+
+  auto chain_future = executor.run(chains);
+  while (!chain_started.load()) {
+    std::this_thread::yield();
+  }
+  bool chain_cancelled = chain_future.cancel();
+  chain_release.store(true);
+  chain_future.wait();
+  std::cout << "semaphore cancelled = " << chain_cancelled << "\n";
+  std::cout << "semaphore value = " << semaphore.value() << "\n";
+
+  chain_executed.store(0);
+  executor.run(chains).wait();
+  std::cout << "semaphore rerun executed = " << chain_executed.load() << "\n";
+
+  return 0;
+}
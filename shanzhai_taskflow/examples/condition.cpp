@@ -0,0 +1,56 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#include "taskflow/taskflow.hpp"
+
+#include <cmath>
+#include <iostream>
+
+/*
+牛顿迭代求sqrt(2)，条件任务返回0时回到step，返回1时进入done
+
++------+     +------+     +-----------+  1  +------+
+| init |---->| step |---->| converged |---->| done |
++------+     +------+     +-----------+     +------+
+                ^               | 0
+                +---------------+
+
+Output:
+sqrt(2) = 1.41421
+iterations = 6
+*/
+
+int main() {
+  ::shanzhai_tf::Executor executor(4);
+  ::shanzhai_tf::Taskflow taskflow;
+
+  double x = 0.0;
+  double prev = 0.0;
+  int iterations = 0;
+
+  auto init = taskflow.emplace([&]() {
+    x = 1.0;
+    iterations = 0;
+  });
+  auto step = taskflow.emplace([&]() {
+    prev = x;
+    x = (x + 2.0 / x) / 2.0;
+    iterations++;
+  });
+  auto converged = taskflow.emplace([&]() -> int { return std::fabs(x - prev) < 1e-12 ? 1 : 0; });
+  auto done = taskflow.emplace([&]() {
+    std::cout << "sqrt(2) = " << x << "\n";
+    std::cout << "iterations = " << iterations << "\n";
+  });
+
+  init.precede(step);
+  step.precede(converged);
+  converged.precede(step, done);
+
+  executor.run(taskflow).wait();
+
+  return 0;
+}
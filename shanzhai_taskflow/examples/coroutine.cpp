@@ -0,0 +1,54 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#include "taskflow/taskflow.hpp"
+
+#include <iostream>
+#include <vector>
+
+/*
+2个Worker同时推进kCoros个协程，需要以C++20编译
+每个协程co_await一个嵌套的CoroTask，嵌套的CoroTask中co_await executor.async的结果，
+之后co_await executor.schedule()让出Worker，再继续执行
+
+Output:
+sum = 1000000
+*/
+
+namespace {
+
+constexpr int kCoros = 1000;
+
+::shanzhai_tf::CoroTask<int> Square(::shanzhai_tf::Executor &executor, int i) {
+  int v = co_await executor.async([i]() { return i * 2; });
+  co_return v;
+}
+
+::shanzhai_tf::CoroTask<int> Work(::shanzhai_tf::Executor &executor, int i) {
+  int v = co_await Square(executor, i);
+  co_await executor.schedule();
+  co_return v + 1;
+}
+
+}  // namespace
+
+int main() {
+  ::shanzhai_tf::Executor executor(2);
+
+  std::vector<::shanzhai_tf::AsyncFuture<int>> futures;
+  futures.reserve(kCoros);
+  for (int i = 0; i < kCoros; i++) {
+    futures.push_back(::shanzhai_tf::co_spawn(executor, Work(executor, i)));
+  }
+
+  long sum = 0;
+  for (auto &fu : futures) {
+    sum += fu.get();
+  }
+  std::cout << "sum = " << sum << "\n";
+
+  return 0;
+}
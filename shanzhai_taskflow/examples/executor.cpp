@@ -0,0 +1,59 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#include "taskflow/core/executor.hpp"
+
+#include <atomic>
+#include <iostream>
+
+/*
+Output:
+counter = 1000
+sum = 5050
+answer = 42
+fib(20) = 6765
+*/
+
+::shanzhai_tf::Executor *executor_ptr = nullptr;
+
+// Worker中等待AsyncFuture时会执行其他任务，即使只有一个Worker也不会死锁
+long Fib(int n) {
+  if (n < 2) {
+    return n;
+  }
+  auto fu = executor_ptr->async([n]() { return Fib(n - 1); });
+  long b = Fib(n - 2);
+  return fu.get() + b;
+}
+
+int main() {
+  ::shanzhai_tf::Executor executor(4);
+
+  std::atomic<int> counter{0};
+  for (int i = 0; i < 1000; i++) {
+    executor.silent_async([&counter]() { counter.fetch_add(1, std::memory_order_relaxed); });
+  }
+  executor.wait_for_all();
+  std::cout << "counter = " << counter.load() << "\n";
+
+  // Worker内部提交的任务进入本地队列
+  std::atomic<int> sum{0};
+  executor.submit([&executor, &sum]() {
+    for (int i = 1; i <= 100; i++) {
+      executor.submit([&sum, i]() { sum.fetch_add(i, std::memory_order_relaxed); });
+    }
+  });
+  executor.wait_for_all();
+  std::cout << "sum = " << sum.load() << "\n";
+
+  auto fu = executor.async([]() { return 42; });
+  std::cout << "answer = " << fu.get() << "\n";
+
+  executor_ptr = &executor;
+  std::cout << "fib(20) = " << executor.async([]() { return Fib(20); }).get() << "\n";
+
+  return 0;
+}
@@ -0,0 +1,74 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#include "taskflow/taskflow.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+/*
+两个pipe组成回声：主线程向ping写入一个字节，on_readable回调在Worker上读出后写入pong，
+再重新注册ping，主线程从pong读回1000个字节；Executor没有单独的I/O线程，空闲的Worker阻塞在epoll_wait上
+
+Output:
+echoed = 1000
+*/
+
+namespace {
+
+constexpr int kRounds = 1000;
+
+int ping[2];
+int pong[2];
+std::atomic<int> echoed{0};
+
+void Echo(::shanzhai_tf::Executor &executor) {
+  executor.io().on_readable(ping[0], [&executor](uint32_t) {
+    char c = 0;
+    while (read(ping[0], &c, 1) == 1) {
+      if (write(pong[1], &c, 1) == 1) {
+        echoed.fetch_add(1, std::memory_order_relaxed);
+      }
+    }
+    if (echoed.load(std::memory_order_relaxed) < kRounds) {
+      Echo(executor);
+    }
+  });
+}
+
+}  // namespace
+
+int main() {
+  if (pipe2(ping, O_NONBLOCK) != 0 || pipe2(pong, O_NONBLOCK) != 0) {
+    return 1;
+  }
+
+  {
+    ::shanzhai_tf::Executor executor(2);
+    Echo(executor);
+    for (int i = 0; i < kRounds; i++) {
+      char c = 'x';
+      if (write(ping[1], &c, 1) != 1) {
+        return 1;
+      }
+      while (read(pong[0], &c, 1) != 1) {
+        std::this_thread::yield();
+      }
+    }
+    executor.wait_for_all();
+  }
+
+  std::cout << "echoed = " << echoed.load() << "\n";
+  for (int fd : {ping[0], ping[1], pong[0], pong[1]}) {
+    close(fd);
+  }
+
+  return 0;
+}
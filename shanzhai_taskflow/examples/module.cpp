@@ -0,0 +1,63 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#include "taskflow/taskflow.hpp"
+
+#include <atomic>
+#include <iostream>
+#include <vector>
+
+/*
+stage是一个4个任务的模块，pipeline在两个分支中各嵌入一次stage，两次嵌入就地运行同一个Graph；
+之后同时运行pipeline 8次，不需要等待上一次运行结束，也不复制任何Taskflow
+
+                +--------------+
+           +--->| module stage |---+
++-------+  |    +--------------+   |   +-----+
+| begin |--+                       +-->| end |
++-------+  |    +--------------+   |   +-----+
+           +--->| module stage |---+
+                +--------------+
+
+Output:
+stage tasks = 64
+runs = 8
+*/
+
+int main() {
+  ::shanzhai_tf::Executor executor(4);
+
+  std::atomic<int> stage_tasks{0};
+  ::shanzhai_tf::Taskflow stage("stage");
+  auto a = stage.emplace([&]() { stage_tasks.fetch_add(1); });
+  auto b = stage.emplace([&]() { stage_tasks.fetch_add(1); });
+  auto c = stage.emplace([&]() { stage_tasks.fetch_add(1); });
+  auto d = stage.emplace([&]() { stage_tasks.fetch_add(1); });
+  a.precede(b, c);
+  d.succeed(b, c);
+
+  std::atomic<int> runs{0};
+  ::shanzhai_tf::Taskflow pipeline("pipeline");
+  auto begin = pipeline.placeholder().name("begin");
+  auto left = pipeline.composed_of(stage).name("left");
+  auto right = pipeline.composed_of(stage).name("right");
+  auto end = pipeline.emplace([&]() { runs.fetch_add(1); }).name("end");
+  begin.precede(left, right);
+  end.succeed(left, right);
+
+  std::vector<::shanzhai_tf::RunFuture> futures;
+  for (int i = 0; i < 8; i++) {
+    futures.push_back(executor.run(pipeline));
+  }
+  for (auto &future : futures) {
+    future.wait();
+  }
+
+  std::cout << "stage tasks = " << stage_tasks.load() << "\n";
+  std::cout << "runs = " << runs.load() << "\n";
+
+  return 0;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#include "taskflow/taskflow.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+注册一个统计任务数量的Observer以及一个ChromeTracer，运行一个A -> {B0..B7} -> C的图，
+ChromeTracer的输出写入observer.json，可以用ui.perfetto.dev打开；
+也可以不修改代码，设置TF_ENABLE_PROFILER=file.json运行任意程序
+
+Output:
+tasks = 10
+trace written to observer.json
+*/
+
+namespace {
+
+// 每个Worker一个计数，只由对应的Worker修改
+class CountObserver : public ::shanzhai_tf::ObserverInterface {
+ public:
+  void set_up(size_t num_workers) override { this->counts_.assign(num_workers, 0); }
+  void on_entry(size_t, ::shanzhai_tf::TaskView) override {}
+  void on_exit(size_t worker_id, ::shanzhai_tf::TaskView) override { this->counts_[worker_id]++; }
+
+  size_t total() const {
+    size_t total = 0;
+    for (auto count : this->counts_) {
+      total += count;
+    }
+    return total;
+  }
+
+ private:
+  std::vector<size_t> counts_;
+};
+
+}  // namespace
+
+int main() {
+  ::shanzhai_tf::Executor executor(4);
+  auto counter = executor.make_observer<CountObserver>();
+  auto tracer = executor.make_observer<::shanzhai_tf::ChromeTracer>();
+
+  ::shanzhai_tf::Taskflow taskflow;
+  auto a = taskflow.emplace([]() {}).name("A");
+  auto c = taskflow.emplace([]() {}).name("C");
+  for (int i = 0; i < 8; i++) {
+    auto b = taskflow.emplace([]() {}).name("B" + std::to_string(i));
+    a.precede(b);
+    b.precede(c);
+  }
+
+  executor.run(taskflow).wait();
+  executor.remove_observer(counter);
+  executor.remove_observer(tracer);
+
+  std::cout << "tasks = " << counter->total() << "\n";
+  std::ofstream ofs("observer.json");
+  tracer->dump(ofs);
+  std::cout << "trace written to observer.json\n";
+
+  return 0;
+}
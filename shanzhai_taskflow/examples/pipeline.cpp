@@ -0,0 +1,67 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#include "taskflow/taskflow.hpp"
+
+#include <array>
+#include <iostream>
+
+/*
+4条line，3个pipe：
+parse（SERIAL）读入第token个输入 -> square（PARALLEL）计算平方 -> write（SERIAL）按顺序输出
+
+Output:
+0 -> 0
+1 -> 1
+2 -> 4
+3 -> 9
+4 -> 16
+5 -> 25
+6 -> 36
+7 -> 49
+8 -> 64
+9 -> 81
+tokens = 10
+*/
+
+int main() {
+  ::shanzhai_tf::Executor executor(4);
+  ::shanzhai_tf::Taskflow taskflow;
+
+  constexpr size_t kNumLines = 4;
+  constexpr int kNumInputs = 10;
+  // 每条line同时只处理一个token，按line保存中间结果
+  std::array<int, kNumLines> inputs{};
+  std::array<int, kNumLines> outputs{};
+  int next_input = 0;
+
+  ::shanzhai_tf::Pipeline pipeline(
+      kNumLines,
+      ::shanzhai_tf::Pipe{::shanzhai_tf::PipeType::SERIAL,
+                          [&](::shanzhai_tf::Pipeflow &pf) {
+                            if (next_input == kNumInputs) {
+                              pf.stop();
+                              return;
+                            }
+                            inputs[pf.line()] = next_input++;
+                          }},
+      ::shanzhai_tf::Pipe{::shanzhai_tf::PipeType::PARALLEL,
+                          [&](::shanzhai_tf::Pipeflow &pf) {
+                            outputs[pf.line()] = inputs[pf.line()] * inputs[pf.line()];
+                          }},
+      ::shanzhai_tf::Pipe{::shanzhai_tf::PipeType::SERIAL, [&](::shanzhai_tf::Pipeflow &pf) {
+                            std::cout << inputs[pf.line()] << " -> " << outputs[pf.line()] << "\n";
+                          }});
+
+  auto init = taskflow.emplace([&]() { next_input = 0; });
+  auto run = taskflow.composed_of(pipeline);
+  init.precede(run);
+
+  executor.run(taskflow).wait();
+  std::cout << "tokens = " << pipeline.num_tokens() << "\n";
+
+  return 0;
+}
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#include "taskflow/taskflow.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+/*
+两个Worker正在执行200个LOW任务（每个约1ms）时提交一个HIGH任务，HIGH任务在LOW任务清空之前被执行；
+之后一个Worker挂起、另一个Worker在执行LOW任务时，HIGH任务直接唤醒挂起的Worker，不需要等待LOW任务
+
+Output:
+high ran ahead of the low backlog = 1
+low executed = 200
+parked worker picked up high = 1
+*/
+
+int main() {
+  ::shanzhai_tf::Executor executor(2);
+
+  std::atomic<int> low_done{0};
+  for (int i = 0; i < 200; i++) {
+    executor.silent_async(
+        [&]() {
+          std::this_thread::sleep_for(std::chrono::milliseconds(1));
+          low_done.fetch_add(1);
+        },
+        ::shanzhai_tf::TaskPriority::LOW);
+  }
+  while (low_done.load() < 10) {
+    std::this_thread::yield();
+  }
+  std::atomic<int> low_before_high{-1};
+  executor.silent_async([&]() { low_before_high.store(low_done.load()); }, ::shanzhai_tf::TaskPriority::HIGH);
+  executor.wait_for_all();
+  std::cout << "high ran ahead of the low backlog = " << (low_before_high.load() < 100) << "\n";
+  std::cout << "low executed = " << low_done.load() << "\n";
+
+  // 第一个任务占住一个Worker直到HIGH任务执行完，另一个Worker挂起
+  std::atomic<bool> high_done{false};
+  executor.silent_async([&]() {
+    while (!high_done.load()) {
+      std::this_thread::yield();
+    }
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  executor.silent_async([&]() { high_done.store(true); }, ::shanzhai_tf::TaskPriority::HIGH);
+  executor.wait_for_all();
+  std::cout << "parked worker picked up high = " << high_done.load() << "\n";
+  return 0;
+}
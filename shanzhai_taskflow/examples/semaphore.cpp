@@ -0,0 +1,51 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#include "taskflow/taskflow.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+/*
+8个Worker执行16个访问“连接池”的任务，Semaphore限制同时最多2个任务持有连接；
+拿不到连接的任务挂在Semaphore上，不占用Worker
+
+Output:
+tasks = 16
+max concurrency = 2
+*/
+
+int main() {
+  ::shanzhai_tf::Executor executor(8);
+  ::shanzhai_tf::Semaphore pool(2);
+
+  std::atomic<int> running{0};
+  std::atomic<int> max_running{0};
+  std::atomic<int> done{0};
+
+  ::shanzhai_tf::Taskflow taskflow;
+  for (int i = 0; i < 16; i++) {
+    taskflow
+        .emplace([&]() {
+          int now = running.fetch_add(1) + 1;
+          for (int prev = max_running.load(); now > prev && !max_running.compare_exchange_weak(prev, now);) {
+          }
+          std::this_thread::sleep_for(std::chrono::milliseconds(10));
+          running.fetch_sub(1);
+          done.fetch_add(1);
+        })
+        .acquire(pool)
+        .release(pool);
+  }
+
+  executor.run(taskflow).wait();
+  std::cout << "tasks = " << done.load() << "\n";
+  std::cout << "max concurrency = " << max_running.load() << "\n";
+
+  return 0;
+}
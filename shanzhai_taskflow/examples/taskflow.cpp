@@ -0,0 +1,76 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#include "taskflow/taskflow.hpp"
+
+#include <atomic>
+#include <iostream>
+
+/*
+       +---+
+ +---->| B |-----+
+ |     +---+     v
++---+          +---+
+| A |          | D |
++---+          +---+
+ |     +---+     ^
+ +---->| C |-----+
+       +---+
+
+Output:
+A
+B/C
+C/B
+D
+runs = 100
+sum = 500500
+*/
+
+// 运行时把[lo, hi)一分为二创建子任务，join期间当前Worker继续执行子任务
+long Sum(long lo, long hi, ::shanzhai_tf::Subflow &sf) {
+  if (hi - lo <= 100) {
+    long sum = 0;
+    for (long i = lo; i < hi; i++) {
+      sum += i;
+    }
+    return sum;
+  }
+  long mid = lo + (hi - lo) / 2;
+  long left = 0;
+  long right = 0;
+  sf.emplace([&left, lo, mid](::shanzhai_tf::Subflow &child) { left = Sum(lo, mid, child); });
+  sf.emplace([&right, mid, hi](::shanzhai_tf::Subflow &child) { right = Sum(mid, hi, child); });
+  sf.join();
+  return left + right;
+}
+
+int main() {
+  ::shanzhai_tf::Executor executor(4);
+  ::shanzhai_tf::Taskflow taskflow("simple");
+
+  auto [A, B, C, D] = taskflow.emplace([]() { std::cout << "A\n"; }, []() { std::cout << "B\n"; },
+                                       []() { std::cout << "C\n"; }, []() { std::cout << "D\n"; });
+  A.precede(B, C);
+  D.succeed(B, C);
+  executor.run(taskflow).wait();
+
+  // 同一个图重复运行，不需要重新构建
+  std::atomic<int> runs{0};
+  ::shanzhai_tf::Taskflow frame("frame");
+  auto [E, F, G] = frame.emplace([]() {}, []() {}, [&runs]() { runs.fetch_add(1, std::memory_order_relaxed); });
+  E.precede(F);
+  F.precede(G);
+  executor.run_n(frame, 100).wait();
+  std::cout << "runs = " << runs.load() << "\n";
+
+  long sum = 0;
+  ::shanzhai_tf::Taskflow dynamic("dynamic");
+  dynamic.emplace([&sum](::shanzhai_tf::Subflow &sf) { sum = Sum(1, 1001, sf); });
+  executor.run(dynamic).wait();
+  std::cout << "sum = " << sum << "\n";
+
+  return 0;
+}
@@ -0,0 +1,36 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+#include "taskflow/algorithm/launch.hpp"
+
+namespace shanzhai_tf {
+
+template <typename B, typename E, typename S, typename C, typename P>
+Task FlowBuilder::for_each_index(B first, E last, S step, C callable, P part) {
+  return this->emplace([first, last, step, callable, part](Subflow &sf) mutable {
+    using I = std::common_type_t<B, E, S>;
+    const size_t n = DistanceIndex(first, last, step);
+    const size_t num_workers = NumLoopWorkers(sf, n, part);
+    std::atomic<size_t> cursor{0};
+    auto job = [&](size_t id) {
+      part.Loop(n, num_workers, id, cursor, [&](size_t begin, size_t end) {
+        I idx = static_cast<I>(first) + static_cast<I>(begin) * static_cast<I>(step);
+        for (size_t i = begin; i < end; i++, idx += static_cast<I>(step)) {
+          callable(idx);
+        }
+      });
+    };
+    ParallelLaunch(sf, num_workers, job);
+  });
+}
+
+}  // namespace shanzhai_tf
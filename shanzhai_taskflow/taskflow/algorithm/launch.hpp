@@ -0,0 +1,65 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+#include "taskflow/algorithm/partitioner.hpp"
+#include "taskflow/core/executor.hpp"
+#include "taskflow/core/flow_builder.hpp"
+
+namespace shanzhai_tf {
+
+/*
+并行算法共用的启动方式
+（1）一个循环最多创建num_workers个子任务，每个子任务调用一次job(i)，分块由Partitioner通过共享cursor完成，
+   块的数量与子任务数量无关
+（2）只需要一个执行者时直接在当前Worker上运行，不创建子任务
+（3）子任务引用父任务栈上的cursor等状态，join返回前它们一定已经执行完
+*/
+template <typename P>
+size_t NumLoopWorkers(Subflow &sf, size_t n, const P &part) {
+  size_t chunk = part.chunk_size() > 0 ? part.chunk_size() : 1;
+  size_t num_chunks = (n + chunk - 1) / chunk;
+  return std::min(sf.executor().num_workers(), num_chunks);
+}
+
+template <typename F>
+void ParallelLaunch(Subflow &sf, size_t num_workers, F &job) {
+  if (num_workers <= 1) {
+    if (num_workers == 1) {
+      job(size_t{0});
+    }
+    return;
+  }
+  for (size_t i = 0; i < num_workers; i++) {
+    sf.emplace([&job, i]() { job(i); });
+  }
+  sf.join();
+}
+
+// [first, last)按step前进的元素个数，step不能为0
+template <typename B, typename E, typename S>
+size_t DistanceIndex(B first, E last, S step) {
+  using I = std::common_type_t<B, E, S>;
+  I b = static_cast<I>(first);
+  I e = static_cast<I>(last);
+  I s = static_cast<I>(step);
+  if (s > 0) {
+    return b < e ? static_cast<size_t>((e - b + s - 1) / s) : 0;
+  }
+  if constexpr (std::is_signed_v<I>) {
+    if (s < 0) {
+      return b > e ? static_cast<size_t>((b - e - s - 1) / (-s)) : 0;
+    }
+  }
+  return 0;
+}
+
+}  // namespace shanzhai_tf
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+
+namespace shanzhai_tf {
+
+/*
+并行算法的分块策略，把[0, n)切成若干[begin, end)交给num_workers个执行者
+（1）每个执行者调用一次Loop(n, num_workers, id, cursor, f)，对分到的每一块调用f(begin, end)
+（2）同一个循环的所有执行者共享一个cursor，分块不创建任何任务对象，每块的调度开销只有一次原子操作
+（3）StaticPartitioner：chunk_size_为0时每个执行者分到连续的一段，否则按chunk_size_轮转分块，
+   不访问cursor，适合每个元素开销均匀的循环
+（4）GuidedPartitioner：每次取剩余数量的1/(2*num_workers)，不小于chunk_size_，
+   开始时块大、接近结束时块小，兼顾开销和负载均衡，是默认策略
+（5）DynamicPartitioner：每次fetch_add固定的chunk_size_，负载最均衡，开销最大
+*/
+class StaticPartitioner {
+ public:
+  explicit StaticPartitioner(size_t chunk_size = 0) : chunk_size_(chunk_size) {}
+
+  template <typename F>
+  void Loop(size_t n, size_t num_workers, size_t id, std::atomic<size_t> &cursor, F &&f) const;
+
+  size_t chunk_size() const { return this->chunk_size_; }
+
+ private:
+  size_t chunk_size_{0};
+};
+
+class GuidedPartitioner {
+ public:
+  explicit GuidedPartitioner(size_t chunk_size = 1) : chunk_size_(std::max<size_t>(chunk_size, 1)) {}
+
+  template <typename F>
+  void Loop(size_t n, size_t num_workers, size_t id, std::atomic<size_t> &cursor, F &&f) const;
+
+  size_t chunk_size() const { return this->chunk_size_; }
+
+ private:
+  size_t chunk_size_{1};
+};
+
+class DynamicPartitioner {
+ public:
+  explicit DynamicPartitioner(size_t chunk_size = 1) : chunk_size_(std::max<size_t>(chunk_size, 1)) {}
+
+  template <typename F>
+  void Loop(size_t n, size_t num_workers, size_t id, std::atomic<size_t> &cursor, F &&f) const;
+
+  size_t chunk_size() const { return this->chunk_size_; }
+
+ private:
+  size_t chunk_size_{1};
+};
+
+using DefaultPartitioner = GuidedPartitioner;
+
+template <typename F>
+void StaticPartitioner::Loop(size_t n, size_t num_workers, size_t id, std::atomic<size_t> &, F &&f) const {
+  size_t chunk = this->chunk_size_ > 0 ? this->chunk_size_ : (n + num_workers - 1) / num_workers;
+  if (chunk == 0) {
+    return;
+  }
+  for (size_t begin = id * chunk; begin < n; begin += chunk * num_workers) {
+    f(begin, std::min(n, begin + chunk));
+  }
+}
+
+template <typename F>
+void GuidedPartitioner::Loop(size_t n, size_t num_workers, size_t, std::atomic<size_t> &cursor, F &&f) const {
+  const size_t threshold = this->chunk_size_ * num_workers * 2;
+  size_t begin = cursor.load(std::memory_order_relaxed);
+  while (begin < n) {
+    size_t remaining = n - begin;
+    // 剩余很少时退化为固定大小的fetch_add，避免CAS失败重试
+    if (remaining <= threshold) {
+      begin = cursor.fetch_add(this->chunk_size_, std::memory_order_relaxed);
+      if (begin >= n) {
+        break;
+      }
+      size_t end = std::min(n, begin + this->chunk_size_);
+      f(begin, end);
+      begin = cursor.load(std::memory_order_relaxed);
+      continue;
+    }
+    size_t end = begin + std::max(this->chunk_size_, remaining / (2 * num_workers));
+    if (cursor.compare_exchange_weak(begin, end, std::memory_order_relaxed, std::memory_order_relaxed)) {
+      f(begin, end);
+      begin = cursor.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+template <typename F>
+void DynamicPartitioner::Loop(size_t n, size_t, size_t, std::atomic<size_t> &cursor, F &&f) const {
+  for (;;) {
+    size_t begin = cursor.fetch_add(this->chunk_size_, std::memory_order_relaxed);
+    if (begin >= n) {
+      break;
+    }
+    f(begin, std::min(n, begin + this->chunk_size_));
+  }
+}
+
+}  // namespace shanzhai_tf
@@ -0,0 +1,204 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "taskflow/core/cache_line.hpp"
+#include "taskflow/core/executor.hpp"
+#include "taskflow/core/flow_builder.hpp"
+#include "taskflow/core/graph.hpp"
+#include "taskflow/core/small_function.hpp"
+
+namespace shanzhai_tf {
+
+enum class PipeType : int {
+  PARALLEL = 1,  // 不同token可以同时执行
+  SERIAL = 2,    // 按token顺序逐个执行
+};
+
+/*
+传给每个Pipe的参数，记录当前token所在的line、pipe以及token编号
+*/
+class Pipeflow {
+  friend class Pipeline;
+
+ public:
+  size_t line() const { return this->line_; }
+  size_t pipe() const { return this->pipe_; }
+  size_t token() const { return this->token_; }
+
+  // 只能在第一个Pipe中调用，当前token不再继续，也不再产生新的token
+  void stop() {
+    assert(this->pipe_ == 0);
+    this->stop_ = true;
+  }
+
+ private:
+  size_t line_{0};
+  size_t pipe_{0};
+  size_t token_{0};
+  bool stop_{false};
+};
+
+class Pipe {
+  friend class Pipeline;
+
+ public:
+  template <typename C>
+  Pipe(PipeType type, C &&callable) : type_(type), callable_(std::forward<C>(callable)) {}
+
+  PipeType type() const { return this->type_; }
+
+ private:
+  PipeType type_;
+  SmallFunction<void(Pipeflow &)> callable_;
+};
+
+/*
+固定num_lines条line的流水线，通过FlowBuilder::composed_of作为一个Task运行
+（1）token t在line t % num_lines上依次经过所有Pipe，第一个Pipe必须是SERIAL，调用stop()后结束
+（2）每个(line, pipe)有一个join_counter_，记录token进入该pipe之前还需要满足的条件：
+   同一条line上一个pipe已完成；pipe为SERIAL时还需要上一条line的上一个token已完成该pipe
+   （第一个pipe的“同一条line上一个pipe”是该line的上一个token走完了最后一个pipe）
+（3）(line, pipe)执行完后先把自己的计数重置为下一个token的初始值，再给两个后继各减一：
+   同一条line的下一个pipe减到0时当前Worker直接继续执行，下一条line减到0时调度那条line的Node，
+   两者都不满足时line结束本次执行，由之后把计数减到0的一方重新调度
+（4）每条line对应一个常驻的Node，作为运行中的流水线Task的动态子任务反复调度，
+   token在pipe之间移动只有原子计数和本地队列操作，不分配内存；
+   没有就绪line时Worker按Notifier的两阶段协议挂起，line就绪时由Schedule唤醒
+（5）运行期间Pipeline不能被移动或销毁，同一个Pipeline同时只能运行一次，包含它的Taskflow不能同时运行多次
+*/
+class Pipeline {
+  friend class FlowBuilder;
+
+  struct alignas(kCacheLineSize) Line {
+    Pipeflow pf_{};
+    std::unique_ptr<std::atomic<size_t>[]> join_counters_{};
+  };
+
+ public:
+  template <typename... Ps>
+  explicit Pipeline(size_t num_lines, Ps &&...pipes);
+  Pipeline(size_t num_lines, std::vector<Pipe> pipes);
+
+  Pipeline(const Pipeline &) = delete;
+  Pipeline &operator=(const Pipeline &) = delete;
+
+  size_t num_lines() const { return this->lines_.size(); }
+  size_t num_pipes() const { return this->pipes_.size(); }
+  // 最近一次运行产生的token数量，不包括调用stop()的token
+  size_t num_tokens() const { return this->num_tokens_; }
+
+ private:
+  void Build(size_t num_lines);
+  void Reset();
+  void Run(Subflow &sf);
+  void RunLine(size_t l);
+  // pipe在执行一次之后需要等待的条件数量
+  size_t NumDeps(size_t p) const { return this->pipes_[p].type_ == PipeType::SERIAL ? 2 : 1; }
+
+  std::vector<Pipe> pipes_;
+  std::vector<Line, AlignedAllocator<Line>> lines_;
+  std::vector<Node *> line_nodes_;
+  Graph graph_{};
+  Executor *executor_{nullptr};
+  Node *parent_{nullptr};
+  size_t num_tokens_{0};
+};
+
+template <typename... Ps>
+Pipeline::Pipeline(size_t num_lines, Ps &&...pipes) {
+  (this->pipes_.emplace_back(std::forward<Ps>(pipes)), ...);
+  this->Build(num_lines);
+}
+
+inline Pipeline::Pipeline(size_t num_lines, std::vector<Pipe> pipes) : pipes_(std::move(pipes)) {
+  this->Build(num_lines);
+}
+
+inline void Pipeline::Build(size_t num_lines) {
+  assert(num_lines > 0);
+  assert(!this->pipes_.empty() && this->pipes_[0].type_ == PipeType::SERIAL);
+  this->lines_.resize(num_lines);
+  for (size_t l = 0; l < num_lines; l++) {
+    this->lines_[l].join_counters_ = std::make_unique<std::atomic<size_t>[]>(this->pipes_.size());
+    this->line_nodes_.push_back(this->graph_.Emplace([this, l]() { this->RunLine(l); }));
+  }
+}
+
+// 第一轮token t = l：第一个pipe只等待上一条line，其余pipe的SERIAL条件在line 0上不存在
+inline void Pipeline::Reset() {
+  const size_t num_pipes = this->pipes_.size();
+  for (size_t l = 0; l < this->lines_.size(); l++) {
+    Line &line = this->lines_[l];
+    line.pf_.line_ = l;
+    line.pf_.pipe_ = 0;
+    line.pf_.token_ = l;
+    line.pf_.stop_ = false;
+    line.join_counters_[0].store(l > 0 ? 1 : 0, std::memory_order_relaxed);
+    for (size_t p = 1; p < num_pipes; p++) {
+      line.join_counters_[p].store(l > 0 ? this->NumDeps(p) : 1, std::memory_order_relaxed);
+    }
+  }
+  this->num_tokens_ = 0;
+}
+
+inline void Pipeline::Run(Subflow &sf) {
+  this->Reset();
+  this->executor_ = &sf.executor_;
+  this->parent_ = sf.parent_;
+  this->executor_->CorunChildren(*this->executor_->workers_[sf.worker_id_], this->parent_, this->line_nodes_.data(),
+                                 this->line_nodes_.size());
+}
+
+inline void Pipeline::RunLine(size_t l) {
+  const size_t num_lines = this->lines_.size();
+  const size_t num_pipes = this->pipes_.size();
+  Line &line = this->lines_[l];
+  for (;;) {
+    const size_t p = line.pf_.pipe_;
+    this->pipes_[p].callable_(line.pf_);
+    if (p == 0 && line.pf_.stop_) {
+      this->num_tokens_ = line.pf_.token_;
+      return;
+    }
+
+    line.join_counters_[p].store(this->NumDeps(p), std::memory_order_relaxed);
+    const size_t next_pipe = (p + 1) % num_pipes;
+    if (next_pipe == 0) {
+      line.pf_.token_ += num_lines;
+    }
+    line.pf_.pipe_ = next_pipe;
+
+    bool ready = line.join_counters_[next_pipe].fetch_sub(1, std::memory_order_acq_rel) == 1;
+    if (this->pipes_[p].type_ == PipeType::SERIAL) {
+      const size_t next_line = (l + 1) % num_lines;
+      if (this->lines_[next_line].join_counters_[p].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        if (next_line == l) {
+          ready = true;
+        } else {
+          this->executor_->SpawnChild(this->parent_, this->line_nodes_[next_line]);
+        }
+      }
+    }
+    if (!ready) {
+      return;
+    }
+  }
+}
+
+inline Task FlowBuilder::composed_of(Pipeline &pipeline) {
+  return this->emplace([&pipeline](Subflow &sf) { pipeline.Run(sf); });
+}
+
+}  // namespace shanzhai_tf
@@ -0,0 +1,60 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include "taskflow/algorithm/launch.hpp"
+
+namespace shanzhai_tf {
+
+/*
+每个子任务先在本地累加分到的所有块，结束时加锁合并到init一次，
+本地结果以分到的第一个元素开始，不要求bop有单位元
+*/
+template <typename B, typename E, typename T, typename BOP, typename P>
+Task FlowBuilder::reduce(B first, E last, T &init, BOP bop, P part) {
+  return this->transform_reduce(
+      first, last, init, bop, [](const auto &v) -> const auto & { return v; }, part);
+}
+
+template <typename B, typename E, typename T, typename BOP, typename UOP, typename P>
+Task FlowBuilder::transform_reduce(B first, E last, T &init, BOP bop, UOP uop, P part) {
+  return this->emplace([first, last, &init, bop, uop, part](Subflow &sf) mutable {
+    const size_t n = static_cast<size_t>(std::distance(first, last));
+    const size_t num_workers = NumLoopWorkers(sf, n, part);
+    std::atomic<size_t> cursor{0};
+    std::mutex mutex;
+    auto job = [&](size_t id) {
+      std::optional<T> local;
+      part.Loop(n, num_workers, id, cursor, [&](size_t begin, size_t end) {
+        auto it = first + begin;
+        size_t i = begin;
+        if (!local) {
+          local.emplace(uop(*it));
+          ++it;
+          ++i;
+        }
+        for (; i < end; i++, ++it) {
+          *local = bop(std::move(*local), uop(*it));
+        }
+      });
+      if (local) {
+        std::lock_guard<std::mutex> lock(mutex);
+        init = bop(std::move(init), std::move(*local));
+      }
+    };
+    ParallelLaunch(sf, num_workers, job);
+  });
+}
+
+}  // namespace shanzhai_tf
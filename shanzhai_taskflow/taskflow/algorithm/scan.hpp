@@ -0,0 +1,66 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <numeric>
+#include <optional>
+#include <vector>
+
+#include "taskflow/algorithm/launch.hpp"
+
+namespace shanzhai_tf {
+
+/*
+两遍扫描，把输入切成num_workers段
+（1）每段各自做inclusive_scan，记录段尾的值
+（2）一个任务顺序计算各段的前缀和
+（3）第i段（i > 0）的每个元素与前i段的和合并
+*/
+template <typename B, typename E, typename D, typename BOP>
+Task FlowBuilder::inclusive_scan(B first, E last, D d_first, BOP bop) {
+  return this->emplace([first, last, d_first, bop](Subflow &sf) mutable {
+    using T = typename std::iterator_traits<B>::value_type;
+    const size_t n = static_cast<size_t>(std::distance(first, last));
+    size_t num_blocks = std::min(sf.executor().num_workers(), n);
+    if (num_blocks <= 1) {
+      std::inclusive_scan(first, last, d_first, bop);
+      return;
+    }
+    const size_t block = (n + num_blocks - 1) / num_blocks;
+    num_blocks = (n + block - 1) / block;
+    std::vector<std::optional<T>> sums(num_blocks);
+    auto combine = sf.emplace([&]() {
+      for (size_t i = 1; i < num_blocks; i++) {
+        sums[i].emplace(bop(*sums[i - 1], *sums[i]));
+      }
+    });
+    for (size_t i = 0; i < num_blocks; i++) {
+      const size_t begin = i * block;
+      const size_t end = std::min(n, begin + block);
+      auto local = sf.emplace([&, begin, end, i]() {
+        std::inclusive_scan(first + begin, first + end, d_first + begin, bop);
+        sums[i].emplace(*(d_first + (end - 1)));
+      });
+      local.precede(combine);
+      if (i > 0) {
+        auto fixup = sf.emplace([&, begin, end, i]() {
+          const T &offset = *sums[i - 1];
+          for (auto out = d_first + begin; out != d_first + end; ++out) {
+            *out = bop(offset, *out);
+          }
+        });
+        combine.precede(fixup);
+      }
+    }
+    sf.join();
+  });
+}
+
+}  // namespace shanzhai_tf
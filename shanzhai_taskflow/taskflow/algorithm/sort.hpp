@@ -0,0 +1,55 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+#include "taskflow/algorithm/launch.hpp"
+
+namespace shanzhai_tf {
+
+/*
+并行快速排序
+（1）三数取中选pivot，三路划分为小于、等于、大于pivot三段，大量重复元素时不会退化
+（2）两侧各作为一个子任务递归，由join所在的Worker与窃取者一起完成
+（3）不超过kSortCutoff个元素时直接std::sort
+*/
+inline constexpr size_t kSortCutoff = 2048;
+
+template <typename I, typename C>
+void ParallelSort(Subflow &sf, I first, I last, C &cmp) {
+  const size_t n = static_cast<size_t>(std::distance(first, last));
+  if (n <= kSortCutoff || sf.executor().num_workers() <= 1) {
+    std::sort(first, last, cmp);
+    return;
+  }
+  auto a = first;
+  auto b = first + n / 2;
+  auto c = last - 1;
+  if (cmp(*b, *a)) {
+    std::swap(a, b);
+  }
+  if (cmp(*c, *b)) {
+    b = cmp(*c, *a) ? a : c;
+  }
+  auto pivot = *b;
+  auto lower = std::partition(first, last, [&](const auto &v) { return cmp(v, pivot); });
+  auto upper = std::partition(lower, last, [&](const auto &v) { return !cmp(pivot, v); });
+  sf.emplace([first, lower, &cmp](Subflow &child) { ParallelSort(child, first, lower, cmp); });
+  sf.emplace([upper, last, &cmp](Subflow &child) { ParallelSort(child, upper, last, cmp); });
+  sf.join();
+}
+
+template <typename B, typename E, typename C>
+Task FlowBuilder::sort(B first, E last, C cmp) {
+  return this->emplace([first, last, cmp](Subflow &sf) mutable { ParallelSort(sf, first, B(last), cmp); });
+}
+
+}  // namespace shanzhai_tf
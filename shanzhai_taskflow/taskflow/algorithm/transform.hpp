@@ -0,0 +1,36 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+
+#include "taskflow/algorithm/launch.hpp"
+
+namespace shanzhai_tf {
+
+template <typename B, typename E, typename O, typename C, typename P>
+Task FlowBuilder::transform(B first, E last, O d_first, C callable, P part) {
+  return this->emplace([first, last, d_first, callable, part](Subflow &sf) mutable {
+    const size_t n = static_cast<size_t>(std::distance(first, last));
+    const size_t num_workers = NumLoopWorkers(sf, n, part);
+    std::atomic<size_t> cursor{0};
+    auto job = [&](size_t id) {
+      part.Loop(n, num_workers, id, cursor, [&](size_t begin, size_t end) {
+        auto it = first + begin;
+        auto out = d_first + begin;
+        for (size_t i = begin; i < end; i++, ++it, ++out) {
+          *out = callable(*it);
+        }
+      });
+    };
+    ParallelLaunch(sf, num_workers, job);
+  });
+}
+
+}  // namespace shanzhai_tf
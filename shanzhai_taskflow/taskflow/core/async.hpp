@@ -0,0 +1,194 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "taskflow/core/object_pool.hpp"
+
+namespace shanzhai_tf {
+
+class CoroSpawner;
+class Executor;
+
+template <typename R>
+class AsyncFuture;
+
+/*
+async任务与AsyncFuture之间共享的结果，从ObjectPool<AsyncState<R>>分配
+（1）refs_初始为2，任务执行完与AsyncFuture析构（或get）各释放一次，减到0时回收
+（2）ready_在结果写入之后置位；等待线程不是Worker时置位waiting_并在cv_上等待，
+   任务完成时只有waiting_为true才需要加锁通知
+（3）co_await AsyncFuture的协程把句柄记录在awaiter_中，awaiter_phase_从NONE改为AWAITING；
+   SetReady把awaiter_phase_改为READY，看到AWAITING时把恢复协程的任务放入Executor的队列，
+   两边都用原子操作修改awaiter_phase_，协程只会被恢复一次
+*/
+template <typename R>
+class AsyncState {
+  friend class CoroSpawner;
+  friend class Executor;
+  friend class AsyncFuture<R>;
+
+  // 引用结果以std::reference_wrapper保存，void结果不需要保存值
+  using ValueT = std::conditional_t<std::is_reference_v<R>, std::reference_wrapper<std::remove_reference_t<R>>,
+                                    std::conditional_t<std::is_void_v<R>, bool, R>>;
+
+ public:
+  explicit AsyncState(Executor *executor) : executor_(executor) {}
+
+ private:
+  template <typename F>
+  void Run(F &f);
+  void SetReady();
+  void Wait();
+  bool Ready() const { return this->ready_.load(std::memory_order_acquire); }
+  void Release();
+  // 结果已经就绪时返回false，协程不需要挂起
+  template <typename H>
+  bool Suspend(H h);
+  // 定义在executor.hpp
+  void ResumeAwaiter();
+
+  enum AwaiterPhase : int {
+    NONE,
+    AWAITING,
+    READY,
+  };
+
+  Executor *executor_{nullptr};
+  std::atomic<int> refs_{2};
+  std::atomic<bool> ready_{false};
+  std::atomic<bool> waiting_{false};
+  std::atomic<int> awaiter_phase_{NONE};
+  void *awaiter_{nullptr};
+  void (*resume_)(void *){nullptr};
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::optional<ValueT> value_{};
+  std::exception_ptr exception_{};
+};
+
+/*
+Executor::async的返回值，只能移动
+（1）wait在Worker线程中调用时会执行其他任务直到结果就绪，不会占住Worker，也不会在Notifier上挂起
+（2）get等待结果后取走值或重新抛出异常，之后valid()为false
+（3）可以在协程中co_await，结果就绪之前协程挂起，Worker回去执行其他任务，
+   结果就绪后协程被放回Executor的队列，在某个Worker上继续执行；co_await的结果与get相同
+*/
+template <typename R>
+class AsyncFuture {
+  friend class CoroSpawner;
+  friend class Executor;
+
+ public:
+  AsyncFuture() = default;
+  ~AsyncFuture();
+
+  AsyncFuture(const AsyncFuture &) = delete;
+  AsyncFuture &operator=(const AsyncFuture &) = delete;
+  AsyncFuture(AsyncFuture &&other) noexcept : state_(std::exchange(other.state_, nullptr)) {}
+  AsyncFuture &operator=(AsyncFuture &&other) noexcept;
+
+  bool valid() const { return this->state_ != nullptr; }
+  bool ready() const { return this->state_ == nullptr || this->state_->Ready(); }
+
+  // 定义在executor.hpp
+  void wait() const;
+  R get();
+
+  // 协程的awaiter接口，H为std::coroutine_handle，只使用address与from_address
+  bool await_ready() const { return this->ready(); }
+  template <typename H>
+  bool await_suspend(H h) {
+    return this->state_->Suspend(h);
+  }
+  R await_resume() { return this->get(); }
+
+ private:
+  explicit AsyncFuture(AsyncState<R> *state) : state_(state) {}
+
+  AsyncState<R> *state_{nullptr};
+};
+
+template <typename R>
+template <typename F>
+void AsyncState<R>::Run(F &f) {
+  try {
+    if constexpr (std::is_void_v<R>) {
+      f();
+      this->value_.emplace(true);
+    } else {
+      this->value_.emplace(f());
+    }
+  } catch (...) {
+    this->exception_ = std::current_exception();
+  }
+  this->SetReady();
+  this->Release();
+}
+
+template <typename R>
+void AsyncState<R>::SetReady() {
+  this->ready_.store(true, std::memory_order_seq_cst);
+  if (this->waiting_.load(std::memory_order_seq_cst)) {
+    { std::lock_guard<std::mutex> lock(this->mutex_); }
+    this->cv_.notify_all();
+  }
+  if (this->awaiter_phase_.exchange(READY, std::memory_order_acq_rel) == AWAITING) {
+    this->ResumeAwaiter();
+  }
+}
+
+template <typename R>
+void AsyncState<R>::Wait() {
+  this->waiting_.store(true, std::memory_order_seq_cst);
+  std::unique_lock<std::mutex> lock(this->mutex_);
+  this->cv_.wait(lock, [this]() { return this->ready_.load(std::memory_order_seq_cst); });
+}
+
+template <typename R>
+template <typename H>
+bool AsyncState<R>::Suspend(H h) {
+  this->awaiter_ = h.address();
+  this->resume_ = [](void *address) { H::from_address(address).resume(); };
+  int expected = NONE;
+  return this->awaiter_phase_.compare_exchange_strong(expected, AWAITING, std::memory_order_acq_rel);
+}
+
+template <typename R>
+void AsyncState<R>::Release() {
+  if (this->refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    ObjectPool<AsyncState<R>>::Instance().Recycle(this);
+  }
+}
+
+template <typename R>
+AsyncFuture<R>::~AsyncFuture() {
+  if (this->state_ != nullptr) {
+    this->state_->Release();
+  }
+}
+
+template <typename R>
+AsyncFuture<R> &AsyncFuture<R>::operator=(AsyncFuture &&other) noexcept {
+  if (this != &other) {
+    if (this->state_ != nullptr) {
+      this->state_->Release();
+    }
+    this->state_ = std::exchange(other.state_, nullptr);
+  }
+  return *this;
+}
+
+}  // namespace shanzhai_tf
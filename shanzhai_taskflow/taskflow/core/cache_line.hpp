@@ -0,0 +1,68 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <limits>
+#include <new>
+
+namespace shanzhai_tf {
+
+/*
+缓存行大小
+std::hardware_destructive_interference_size 的取值随编译器版本和 -mtune 变化，
+GCC 在头文件中使用它会触发 -Winterference-size（-Werror 下直接报错），
+所以这里按平台固定取值
+*/
+#if (defined(__aarch64__) && defined(__APPLE__)) || defined(__powerpc64__)
+inline constexpr size_t kCacheLineSize = 128;
+#else
+inline constexpr size_t kCacheLineSize = 64;
+#endif
+
+/*
+按Align对齐分配内存的分配器，用于存放alignas(kCacheLineSize)的对象，
+保证容器中相邻元素不会共享缓存行
+*/
+template <typename T, size_t Align = kCacheLineSize>
+class AlignedAllocator {
+  static_assert(Align >= alignof(T), "Align must not be smaller than alignof(T)");
+
+ public:
+  using value_type = T;
+
+  template <typename U>
+  struct rebind {
+    using other = AlignedAllocator<U, Align>;
+  };
+
+  AlignedAllocator() noexcept = default;
+
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, Align> &) noexcept {}  // NOLINT
+
+  T *allocate(size_t n) {
+    if (n > std::numeric_limits<size_t>::max() / sizeof(T)) {
+      throw std::bad_array_new_length();
+    }
+    return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(Align)));
+  }
+
+  void deallocate(T *p, size_t) noexcept { ::operator delete(p, std::align_val_t(Align)); }
+
+  template <typename U>
+  bool operator==(const AlignedAllocator<U, Align> &) const noexcept {
+    return true;
+  }
+
+  template <typename U>
+  bool operator!=(const AlignedAllocator<U, Align> &) const noexcept {
+    return false;
+  }
+};
+
+}  // namespace shanzhai_tf
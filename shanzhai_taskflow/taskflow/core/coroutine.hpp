@@ -0,0 +1,220 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+// 只有以C++20编译时才提供CoroTask，C++17下这个头文件为空
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define SHANZHAI_TF_HAS_COROUTINE 1
+#endif
+#endif
+
+#ifdef SHANZHAI_TF_HAS_COROUTINE
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "taskflow/core/async.hpp"
+#include "taskflow/core/executor.hpp"
+#include "taskflow/core/object_pool.hpp"
+
+namespace shanzhai_tf {
+
+template <typename T = void>
+class CoroTask;
+
+// CoroTask的结果，void只保存异常
+template <typename T>
+class CoroResult {
+ public:
+  template <typename U>
+  void return_value(U &&value) {
+    this->value_.emplace(std::forward<U>(value));
+  }
+  void unhandled_exception() noexcept { this->exception_ = std::current_exception(); }
+
+  T Result() {
+    if (this->exception_) {
+      std::rethrow_exception(this->exception_);
+    }
+    return std::move(*this->value_);
+  }
+
+ private:
+  std::optional<T> value_{};
+  std::exception_ptr exception_{};
+};
+
+template <>
+class CoroResult<void> {
+ public:
+  void return_void() noexcept {}
+  void unhandled_exception() noexcept { this->exception_ = std::current_exception(); }
+
+  void Result() {
+    if (this->exception_) {
+      std::rethrow_exception(this->exception_);
+    }
+  }
+
+ private:
+  std::exception_ptr exception_{};
+};
+
+/*
+惰性启动、只能移动的协程任务，名字避开表示图中Node句柄的Task
+（1）创建时不执行，第一次被co_await时才开始执行，结束时通过对称转移直接恢复co_await它的协程，
+   不经过队列，也不会因为多层嵌套而增长调用栈
+（2）协程体中co_await executor.schedule()或者co_await AsyncFuture时挂起，
+   Worker回去执行队列中的其他任务，恢复协程的任务被放回Executor的队列，
+   因此少量Worker可以同时推进大量处于等待中的协程
+（3）最外层的CoroTask通过co_spawn交给Executor运行，返回的AsyncFuture可以wait/get，
+   也可以在其他协程中co_await
+（4）每个CoroTask只能被co_await一次，CoroTask析构时销毁协程帧
+*/
+template <typename T>
+class CoroTask {
+  static_assert(!std::is_reference_v<T>, "CoroTask does not support reference results");
+
+ public:
+  class promise_type : public CoroResult<T> {
+    friend class CoroTask;
+
+   public:
+    CoroTask get_return_object() noexcept {
+      return CoroTask(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    auto final_suspend() const noexcept {
+      struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) const noexcept {
+          return h.promise().continuation_;
+        }
+        void await_resume() const noexcept {}
+      };
+      return FinalAwaiter{};
+    }
+
+   private:
+    std::coroutine_handle<> continuation_{std::noop_coroutine()};
+  };
+
+  CoroTask() = default;
+  ~CoroTask();
+
+  CoroTask(const CoroTask &) = delete;
+  CoroTask &operator=(const CoroTask &) = delete;
+  CoroTask(CoroTask &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+  CoroTask &operator=(CoroTask &&other) noexcept;
+
+  bool valid() const { return static_cast<bool>(this->handle_); }
+
+  bool await_ready() const noexcept { return !this->handle_ || this->handle_.done(); }
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept;
+  T await_resume() { return this->handle_.promise().Result(); }
+
+ private:
+  explicit CoroTask(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+  std::coroutine_handle<promise_type> handle_{};
+};
+
+/*
+co_spawn的实现，外层协程先切换到Worker上，再co_await用户的CoroTask，结束后写入AsyncState
+（1）协程挂起期间计入Executor的num_topologies_，wait_for_all会等待所有co_spawn的协程结束
+（2）外层协程的initial_suspend与final_suspend都不挂起，执行结束后协程帧自动销毁
+*/
+class CoroSpawner {
+ public:
+  template <typename T>
+  static AsyncFuture<T> Spawn(Executor &executor, CoroTask<T> task, TaskPriority priority);
+
+ private:
+  struct Detached {
+    struct promise_type {
+      Detached get_return_object() const noexcept { return {}; }
+      std::suspend_never initial_suspend() const noexcept { return {}; }
+      std::suspend_never final_suspend() const noexcept { return {}; }
+      void return_void() const noexcept {}
+      // 异常都在Drive里捕获
+      void unhandled_exception() const noexcept { std::terminate(); }
+    };
+  };
+
+  template <typename T>
+  static Detached Drive(Executor &executor, CoroTask<T> task, AsyncState<T> *state, TaskPriority priority);
+};
+
+// 在executor上运行task，返回的AsyncFuture得到task的结果或者异常
+template <typename T>
+AsyncFuture<T> co_spawn(Executor &executor, CoroTask<T> task, TaskPriority priority = TaskPriority::NORMAL) {
+  return CoroSpawner::Spawn(executor, std::move(task), priority);
+}
+
+template <typename T>
+CoroTask<T>::~CoroTask() {
+  if (this->handle_) {
+    this->handle_.destroy();
+  }
+}
+
+template <typename T>
+CoroTask<T> &CoroTask<T>::operator=(CoroTask &&other) noexcept {
+  if (this != &other) {
+    if (this->handle_) {
+      this->handle_.destroy();
+    }
+    this->handle_ = std::exchange(other.handle_, nullptr);
+  }
+  return *this;
+}
+
+template <typename T>
+std::coroutine_handle<> CoroTask<T>::await_suspend(std::coroutine_handle<> continuation) noexcept {
+  this->handle_.promise().continuation_ = continuation;
+  return this->handle_;
+}
+
+template <typename T>
+AsyncFuture<T> CoroSpawner::Spawn(Executor &executor, CoroTask<T> task, TaskPriority priority) {
+  auto state = ObjectPool<AsyncState<T>>::Instance().Animate(&executor);
+  executor.num_topologies_.fetch_add(1, std::memory_order_relaxed);
+  Drive(executor, std::move(task), state, priority);
+  return AsyncFuture<T>(state);
+}
+
+template <typename T>
+CoroSpawner::Detached CoroSpawner::Drive(Executor &executor, CoroTask<T> task, AsyncState<T> *state,
+                                         TaskPriority priority) {
+  co_await executor.schedule(priority);
+  {
+    // 在计数减少之前销毁用户的协程帧，wait_for_all返回之后不会再访问协程捕获的对象
+    CoroTask<T> inner = std::move(task);
+    try {
+      if constexpr (std::is_void_v<T>) {
+        co_await inner;
+        state->value_.emplace(true);
+      } else {
+        state->value_.emplace(co_await inner);
+      }
+    } catch (...) {
+      state->exception_ = std::current_exception();
+    }
+  }
+  state->SetReady();
+  state->Release();
+  executor.DecrementTopology();
+}
+
+}  // namespace shanzhai_tf
+
+#endif  // SHANZHAI_TF_HAS_COROUTINE
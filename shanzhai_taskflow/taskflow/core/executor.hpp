@@ -0,0 +1,1274 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "taskflow/core/async.hpp"
+#include "taskflow/core/graph.hpp"
+#include "taskflow/core/io.hpp"
+#include "taskflow/core/notifier.hpp"
+#include "taskflow/core/numa.hpp"
+#include "taskflow/core/object_pool.hpp"
+#include "taskflow/core/observer.hpp"
+#include "taskflow/core/profiler.hpp"
+#include "taskflow/core/semaphore.hpp"
+#include "taskflow/core/sharded_notifier.hpp"
+#include "taskflow/core/taskflow.hpp"
+#include "taskflow/core/topology.hpp"
+#include "taskflow/core/tsq.hpp"
+#include "taskflow/core/worker.hpp"
+
+namespace shanzhai_tf {
+
+class Executor;
+
+/*
+Executor::schedule的返回值，co_await时挂起当前协程，把恢复协程的任务放入Executor的队列，
+协程之后在某个Worker上继续执行；只使用协程句柄的resume，不依赖<coroutine>
+*/
+class ScheduleAwaiter {
+ public:
+  ScheduleAwaiter(Executor &executor, TaskPriority priority) : executor_(executor), priority_(priority) {}
+
+  bool await_ready() const noexcept { return false; }
+  // 任务入队之后协程可能已经在其他Worker上恢复并销毁了awaiter，入队之后不能再访问this
+  template <typename H>
+  void await_suspend(H h);
+  void await_resume() const noexcept {}
+
+ private:
+  Executor &executor_;
+  TaskPriority priority_;
+};
+
+/*
+工作窃取线程池
+（1）每个Worker拥有一个固定容量的本地队列，Worker内部提交的任务放入本地队列，
+   外部线程提交的任务以及本地队列溢出的任务放入共享队列（加锁Push，无锁Steal）
+（2）Worker先执行本地队列中的任务，本地队列为空后随机窃取其他Worker以及共享队列
+（3）窃取不到任务时按照Notifier的两阶段协议休眠：
+   PrepareWait -> 再次检查所有队列 -> 有任务则CancelWait，否则CommitWait
+   提交任务的一方先入队再Notify，因此不会丢失唤醒
+（4）运行Taskflow时，Node完成后把join_counter_减到0的后继标记为就绪：
+   第一个就绪的后继由当前Worker直接执行，其余放入本地队列并通过NotifyN一次唤醒对应数量的Worker；
+   条件任务选中的后继同样由当前Worker直接执行，不经过队列，也不修改Topology的计数，
+   因此环上的每一轮迭代只有一次任务调用的开销
+（5）Worker按WorkerAffinity绑核，默认按编号连续地分配到各个NUMA节点，存在多个节点时绑定到所在节点的cpu上；
+   每个节点对应ShardedNotifier的一个分片，Notify优先唤醒与调用线程同一节点的Worker。
+   Worker线程绑核并执行WorkerInterface::scheduler_prologue之后才分配自己的Worker，
+   本地队列按first-touch位于所在节点的内存上，见worker.hpp
+（6）async/silent_async的可调用对象存放在Node内部，Worker内部调用时放入本地队列；
+   Worker等待AsyncFuture时通过CorunUntil执行本地队列以及窃取到的任务，直到结果就绪
+（7）Subflow::join把子任务放入本地队列后CorunUntil，连续窃取失败后按两阶段协议挂起，
+   最后一个完成的子任务通过NotifyWaiter唤醒父任务所在的Worker
+（8）Pipeline的每条line是运行中的流水线Task的动态子任务，CorunChildren调度第一条line，
+   之后由line之间通过SpawnChild互相调度，计数方式与Subflow相同
+（9）每个Worker以及共享队列为每个优先级各有一个队列，Pop与Steal都先检查高优先级；
+   多个后继同时就绪时由当前Worker直接执行优先级最高的那个。
+   HIGH任务入队后用release store记录所在队列（high_victim_），被唤醒的Worker第一次窃取就去那里，
+   不会先在其他Worker的低优先级任务中随机寻找；该队列的HIGH队列为空之后才用CAS清除提示，
+   窃取失败或者队列中还有HIGH任务时提示保留给下一个Worker。
+   每个HIGH任务入队后通过NotifyWaiter直接唤醒调用者所在分片中一个挂起的Worker，
+   不经过Notify(false)优先唤醒PrepareWait线程的路径；该分片没有挂起的Worker时才退回Notify(false)，
+   由ShardedNotifier依次检查其他分片，入队一方的开销与单个分片的Worker数量成正比
+（10）Observer保存在固定数量的原子槽位中，没有Observer时每个任务只多一次relaxed load；
+   移除的Observer在Executor析构之前不会释放，回调中的Worker不会访问到已经释放的对象。
+   设置了TF_ENABLE_PROFILER时构造时注册一个ChromeTracer，见profiler.hpp
+（11）协程通过co_await schedule()或者co_await AsyncFuture挂起，恢复协程的任务与silent_async相同，
+   挂起期间不占用Worker；CoroTask与co_spawn见coroutine.hpp
+（12）Linux下io()返回的IoContext存在之后，挂起的Worker中有一个阻塞在epoll_wait上，
+   I/O事件的回调由这个Worker放入本地队列后直接执行，见io.hpp
+（13）声明了acquire的Node在Invoke开始时获取Semaphore，失败时挂到Semaphore的等待队列上并直接返回，
+   不占用Worker；执行结束后归还release声明的Semaphore，被唤醒的Node放入归还者的本地队列，见semaphore.hpp
+（14）run从Taskflow取一个空闲的Topology，不同的run可以同时运行同一个Taskflow；
+   composed_of(Taskflow&)的模块任务执行时同样取一个Topology，模块的Node作为模块任务的动态子任务就地运行，
+   计数方式与Subflow相同。Invoke通过Origin()读取实例Node的定义，通过Resolve找到后继在同一次运行中的Node
+（15）RunFuture::cancel设置Topology的cancelled_，Invoke在获取Semaphore之前与之后各检查一次（relaxed load），
+   已取消时跳过Node的执行与后继，只完成计数，之后才被取消时先归还刚获取的Semaphore；
+   子任务与模块的Node使用外层的Topology，同样被跳过。
+   本次运行还有未完成的Node时唤醒所有挂起的Worker，尽快清空队列中剩余的Node。
+   acquire与release不成对的Node执行时把净获取数量记入Topology::held_，被跳过的Node不获取也不归还，
+   取消之后每个Node结束或者挂到Semaphore上之前检查本次运行是否还有正在执行的Node
+   （join_counter_等于挂在Semaphore上的数量），没有时代为归还held_中剩余的数量，
+   之后执行的Node都会被跳过，不会再有Node归还它们
+*/
+class Executor {
+  template <typename R>
+  friend class AsyncFuture;
+  friend class CoroSpawner;
+  friend class FlowBuilder;
+  friend class Pipeline;
+  friend class RunFuture;
+  friend class Subflow;
+
+  struct Worker {
+    size_t id_{0};
+    size_t shard_{0};
+    Executor *executor_{nullptr};
+    ShardedNotifier<Notifier>::Waiter *waiter_{nullptr};
+    std::default_random_engine rdgen_{std::random_device{}()};
+    std::array<BoundedTaskQueue<Node *>, kNumTaskPriorities> wsq_;
+    std::vector<Node *> ready_;  // Invoke中暂存除第一个以外的就绪后继，复用容量
+  };
+
+ public:
+  // wif不为空时每个Worker线程启动与退出时回调wif，见worker.hpp
+  explicit Executor(size_t N = std::thread::hardware_concurrency(), WorkerAffinity affinity = WorkerAffinity::numa(),
+                    std::shared_ptr<WorkerInterface> wif = nullptr);
+  ~Executor();
+
+  Executor(const Executor &) = delete;
+  Executor &operator=(const Executor &) = delete;
+
+  // 提交一个不关心结果的任务，等同于silent_async
+  template <typename F>
+  void submit(F &&f, TaskPriority priority = TaskPriority::NORMAL);
+
+  // 提交一个不关心结果的任务，任务抛出的异常不会被捕获
+  template <typename F>
+  void silent_async(F &&f, TaskPriority priority = TaskPriority::NORMAL);
+
+  // 提交一个任务，返回AsyncFuture获取结果或异常
+  template <typename F>
+  auto async(F &&f, TaskPriority priority = TaskPriority::NORMAL)
+      -> AsyncFuture<std::invoke_result_t<std::decay_t<F>>>;
+
+  // 在协程中co_await，把协程转移到Worker上继续执行
+  ScheduleAwaiter schedule(TaskPriority priority = TaskPriority::NORMAL);
+
+  // 运行一次taskflow，返回的RunFuture可以等待这次运行结束；
+  // taskflow正在运行时也立即开始，与之前的运行同时执行
+  RunFuture run(Taskflow &taskflow);
+
+  // 连续运行n次taskflow，n次运行依次执行，返回的RunFuture等待最后一次运行结束
+  RunFuture run_n(Taskflow &taskflow, size_t n);
+
+  // 阻塞直到所有已提交的任务以及Taskflow运行完成
+  void wait_for_all();
+
+  size_t num_workers() const;
+
+  // 当前线程是本Executor的Worker时返回其id，否则返回-1
+  int this_worker_id() const;
+
+  // 创建并注册一个Observer，超过kMaxObservers个时抛出std::length_error
+  template <typename O, typename... ArgsT>
+  std::shared_ptr<O> make_observer(ArgsT &&...args);
+
+  // 之后的任务不再回调observer
+  template <typename O>
+  void remove_observer(std::shared_ptr<O> observer);
+
+  size_t num_observers() const;
+
+  static constexpr size_t kMaxObservers = 8;
+
+#ifdef __linux__
+  // 第一次调用时创建，与Executor的生命周期相同
+  IoContext &io();
+#endif
+
+ private:
+  static Worker *&ThisWorker();
+
+  std::vector<size_t> AssignShards();
+  size_t HomeShard() const;
+  void Spawn(size_t N);
+  // Worker线程的入口，绑核、分配Worker，所有Worker分配完成后进入Loop
+  void Run(size_t id);
+  void Loop(Worker &w);
+  void ExploitTask(Worker &w, Node *&t);
+  bool WaitForTask(Worker &w, Node *&t);
+  // PrepareWait之后调用，挂起前后回调Observer
+  void Park(Worker &w);
+  // 由w阻塞在epoll_wait上等待，已经有其他Worker在等待时返回false
+  bool ParkOnIo(Worker &w);
+  void ExploreTask(Worker &w, Node *&t);
+  // park为false时找不到任务只让出cpu，为true时由让stop()变为true的一方负责NotifyWaiter
+  template <typename P>
+  void CorunUntil(Worker &w, P &&stop, bool park);
+  void CorunGraph(Worker &w, Node *parent, Graph &graph);
+  // 把children绑定为parent的动态子任务并调度children[0]，直到parent的所有动态子任务完成
+  void CorunChildren(Worker &w, Node *parent, Node *const *children, size_t n);
+  // 在sf的父任务中就地运行module，module的Node作为父任务的动态子任务
+  void CorunModule(Subflow &sf, Taskflow &module);
+  // 调度parent的一个已绑定的动态子任务，只能在parent的其他子任务执行期间调用，child可以重复调度
+  void SpawnChild(Node *parent, Node *child);
+  bool HasQueuedTask() const;
+  bool SharedEmpty() const;
+  Node *PopLocal(Worker &w);
+  Node *StealShared();
+  // vtm为w自己时窃取共享队列
+  Node *StealFrom(Worker &w, size_t vtm);
+  // 优先窃取high_victim_的HIGH队列，没有时随机选择victim
+  Node *StealFirst(Worker &w, size_t vtm);
+  // priority需要在入队之前读出，入队之后node可能已经执行完，所在的Topology可能已经开始下一次运行；
+  // priority为HIGH时返回true
+  bool MarkHigh(TaskPriority priority, size_t victim);
+  // 唤醒一个挂起中的Worker执行刚入队的HIGH任务，优先shard分片
+  void NotifyHigh(size_t shard);
+  // n个任务入队之后调用，其中num_high个HIGH任务各自定向唤醒，其余的一次NotifyN
+  void NotifyPushed(size_t n, size_t num_high, size_t shard);
+  void Schedule(Node *node);
+  void Schedule(Node *const *nodes, size_t n);
+  // node为HIGH任务时返回true
+  bool PushLocal(Worker &w, Node *node);
+  Node *Invoke(Worker &w, Node *node);
+  // 失败时node已经挂到某个Semaphore的等待队列上，之后不能再访问node
+  bool AcquireSemaphores(Worker &w, Node *node);
+  void ReleaseSemaphores(Worker &w, Node *node);
+  // Invoke获取之后发现已经取消时归还acquire声明的Semaphore
+  void ReturnSemaphores(Worker &w, Node *node);
+  void HandoffSemaphores(Worker &w, Node *node);
+  void CountHeld(Topology *tp, const NodeSemaphores &semaphores);
+  // 与Semaphore::Wait相同，挂起之前计入tp的等待数量
+  bool WaitSemaphore(Worker &w, Semaphore *semaphore, Node *node);
+  // tp已取消并且除了self个调用者之外没有正在执行的Node时，归还held_中剩余的数量
+  void SettleCancelled(Worker &w, Topology *tp, size_t self);
+  // 把Semaphore唤醒的node放回w的本地队列，node已经计入所属的Topology
+  void ResumeWaiter(Worker &w, Node *node);
+  void AddObserver(std::shared_ptr<ObserverInterface> observer, size_t num_workers);
+  // 没有Observer时只有一次relaxed load
+  template <typename F>
+  void Observe(F &&f);
+  void SetupTopology(Topology *tp);
+  // 重置frame中每个Node本次运行的状态，计入tp并以parent为父任务，源点写入frame->sources_
+  void BindTopology(Topology *frame, Topology *tp, Node *parent);
+  void TearDownTopology(Topology *tp);
+  void DecrementTopology(size_t n = 1);
+
+  NumaTopology numa_;
+  std::vector<size_t> shard_nodes_;             // 分片 -> numa_节点下标
+  std::vector<size_t> node_shards_;             // numa_节点下标 -> 分片，没有Worker的节点映射到分片0
+  std::vector<std::vector<size_t>> shard_workers_;  // 分片 -> Worker编号
+  std::vector<std::vector<int>> worker_cpus_;  // Worker编号 -> 绑定的cpu，为空表示不绑核
+  std::vector<size_t> worker_shards_;          // Worker编号 -> 分片
+
+  std::shared_ptr<WorkerInterface> wif_;
+  std::mutex spawn_mutex_;
+  std::condition_variable spawn_cv_;
+  size_t num_spawned_{0};
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::thread> threads_;
+  ShardedNotifier<Notifier> notifier_;
+
+  std::mutex wsq_mutex_;
+  std::array<UnboundedTaskQueue<Node *>, kNumTaskPriorities> wsq_;
+  // 最近放入HIGH任务的队列，Worker编号或者num_workers()（共享队列）
+  std::atomic<size_t> high_victim_{SIZE_MAX};
+
+  std::mutex topology_mutex_;
+  std::condition_variable topology_cv_;
+  std::atomic<size_t> num_topologies_{0};
+
+  std::atomic<size_t> num_observers_{0};
+  std::array<std::atomic<ObserverInterface *>, kMaxObservers> observers_{};
+  std::mutex observer_mutex_;
+  std::vector<std::shared_ptr<ObserverInterface>> observer_owners_;  // 包括已经移除的Observer
+
+#ifdef __linux__
+  std::mutex io_mutex_;
+  std::unique_ptr<IoContext> io_owner_;
+  std::atomic<IoContext *> io_{nullptr};
+#endif
+
+  std::atomic<bool> done_{false};
+};
+
+inline Executor::Executor(size_t N, WorkerAffinity affinity, std::shared_ptr<WorkerInterface> wif)
+    : numa_(NumaTopology::Detect()),
+      worker_cpus_(affinity.Assign(numa_, N == 0 ? 1 : N)),
+      worker_shards_(this->AssignShards()),
+      wif_(std::move(wif)),
+      notifier_(worker_shards_) {
+  // Worker启动之前注册，第一个任务就能被记录
+  if (auto tracer = Profiler::Instance().NewTracer(); tracer != nullptr) {
+    this->AddObserver(std::move(tracer), N == 0 ? 1 : N);
+  }
+  this->Spawn(N == 0 ? 1 : N);
+}
+
+inline Executor::~Executor() {
+  this->wait_for_all();
+  this->done_.store(true, std::memory_order_seq_cst);
+  this->notifier_.Notify(true);
+  for (auto &thread : this->threads_) {
+    thread.join();
+  }
+}
+
+inline size_t Executor::num_workers() const { return this->workers_.size(); }
+
+inline int Executor::this_worker_id() const {
+  Worker *w = ThisWorker();
+  return (w != nullptr && w->executor_ == this) ? static_cast<int>(w->id_) : -1;
+}
+
+template <typename O, typename... ArgsT>
+std::shared_ptr<O> Executor::make_observer(ArgsT &&...args) {
+  static_assert(std::is_base_of_v<ObserverInterface, O>, "O must derive from ObserverInterface");
+  auto observer = std::make_shared<O>(std::forward<ArgsT>(args)...);
+  this->AddObserver(observer, this->workers_.size());
+  return observer;
+}
+
+template <typename O>
+void Executor::remove_observer(std::shared_ptr<O> observer) {
+  static_assert(std::is_base_of_v<ObserverInterface, O>, "O must derive from ObserverInterface");
+  std::lock_guard<std::mutex> lock(this->observer_mutex_);
+  for (auto &slot : this->observers_) {
+    if (slot.load(std::memory_order_relaxed) == observer.get()) {
+      slot.store(nullptr, std::memory_order_relaxed);
+      this->num_observers_.fetch_sub(1, std::memory_order_relaxed);
+      return;
+    }
+  }
+}
+
+inline size_t Executor::num_observers() const { return this->num_observers_.load(std::memory_order_relaxed); }
+
+inline void Executor::AddObserver(std::shared_ptr<ObserverInterface> observer, size_t num_workers) {
+  observer->set_up(num_workers);
+  std::lock_guard<std::mutex> lock(this->observer_mutex_);
+  for (auto &slot : this->observers_) {
+    if (slot.load(std::memory_order_relaxed) == nullptr) {
+      // release保证Worker看到指针时set_up已经完成
+      slot.store(observer.get(), std::memory_order_release);
+      this->num_observers_.fetch_add(1, std::memory_order_relaxed);
+      this->observer_owners_.push_back(std::move(observer));
+      return;
+    }
+  }
+  throw std::length_error("shanzhai_tf::Executor: too many observers");
+}
+
+template <typename F>
+void Executor::Observe(F &&f) {
+  if (this->num_observers_.load(std::memory_order_relaxed) == 0) {
+    return;
+  }
+  for (auto &slot : this->observers_) {
+    if (ObserverInterface *observer = slot.load(std::memory_order_acquire); observer != nullptr) {
+      f(*observer);
+    }
+  }
+}
+
+inline Executor::Worker *&Executor::ThisWorker() {
+  static thread_local Worker *worker = nullptr;
+  return worker;
+}
+
+template <typename F>
+void Executor::submit(F &&f, TaskPriority priority) {
+  this->silent_async(std::forward<F>(f), priority);
+}
+
+template <typename F>
+void Executor::silent_async(F &&f, TaskPriority priority) {
+  this->num_topologies_.fetch_add(1, std::memory_order_relaxed);
+  Node *node = ObjectPool<Node>::Instance().Animate(AsyncWorkTag{}, std::forward<F>(f));
+  node->priority_ = priority;
+  this->Schedule(node);
+}
+
+template <typename F>
+auto Executor::async(F &&f, TaskPriority priority) -> AsyncFuture<std::invoke_result_t<std::decay_t<F>>> {
+  using R = std::invoke_result_t<std::decay_t<F>>;
+  auto state = ObjectPool<AsyncState<R>>::Instance().Animate(this);
+  this->silent_async([state, f = std::forward<F>(f)]() mutable { state->Run(f); }, priority);
+  return AsyncFuture<R>(state);
+}
+
+inline ScheduleAwaiter Executor::schedule(TaskPriority priority) { return ScheduleAwaiter(*this, priority); }
+
+template <typename H>
+void ScheduleAwaiter::await_suspend(H h) {
+  this->executor_.silent_async([h]() mutable { h.resume(); }, this->priority_);
+}
+
+inline void Executor::wait_for_all() {
+  std::unique_lock<std::mutex> lock(this->topology_mutex_);
+  this->topology_cv_.wait(lock, [this]() { return this->num_topologies_.load(std::memory_order_acquire) == 0; });
+}
+
+// 绑核的Worker属于第一个cpu所在的节点，没有绑核的Worker属于节点0，分片按节点出现的顺序编号
+inline std::vector<size_t> Executor::AssignShards() {
+  const size_t N = this->worker_cpus_.size();
+  this->node_shards_.assign(this->numa_.NumNodes(), SIZE_MAX);
+  std::vector<size_t> shards(N);
+  for (size_t i = 0; i < N; i++) {
+    const auto &cpus = this->worker_cpus_[i];
+    size_t node = cpus.empty() ? 0 : this->numa_.NodeOf(cpus[0]);
+    if (this->node_shards_[node] == SIZE_MAX) {
+      this->node_shards_[node] = this->shard_nodes_.size();
+      this->shard_nodes_.push_back(node);
+    }
+    shards[i] = this->node_shards_[node];
+    this->shard_workers_.resize(this->shard_nodes_.size());
+    this->shard_workers_[shards[i]].push_back(i);
+  }
+  for (auto &shard : this->node_shards_) {
+    if (shard == SIZE_MAX) {
+      shard = 0;
+    }
+  }
+  return shards;
+}
+
+inline size_t Executor::HomeShard() const {
+  Worker *w = ThisWorker();
+  if (w != nullptr && w->executor_ == this) {
+    return w->shard_;
+  }
+  return this->shard_nodes_.size() > 1 ? this->node_shards_[this->numa_.CurrentNode()] : 0;
+}
+
+inline void Executor::Spawn(size_t N) {
+  this->workers_.resize(N);
+  this->threads_.reserve(N);
+  for (size_t i = 0; i < N; i++) {
+    this->threads_.emplace_back([this, i]() { this->Run(i); });
+  }
+  std::unique_lock<std::mutex> lock(this->spawn_mutex_);
+  this->spawn_cv_.wait(lock, [this, N]() { return this->num_spawned_ == N; });
+}
+
+inline void Executor::Run(size_t id) {
+  const auto &cpus = this->worker_cpus_[id];
+  NumaTopology::PinThisThread(cpus);
+  if (this->wif_ != nullptr) {
+    this->wif_->scheduler_prologue(id, cpus);
+  }
+
+  // 在绑核之后由Worker线程自己分配
+  auto w = std::make_unique<Worker>();
+  w->id_ = id;
+  w->shard_ = this->worker_shards_[id];
+  w->executor_ = this;
+  w->waiter_ = this->notifier_.GetWaiter(id);
+  Worker &worker = *w;
+
+  // 窃取时会访问workers_，所有Worker分配完成后才开始执行任务
+  {
+    std::unique_lock<std::mutex> lock(this->spawn_mutex_);
+    this->workers_[id] = std::move(w);
+    if (++this->num_spawned_ == this->workers_.size()) {
+      this->spawn_cv_.notify_all();
+    } else {
+      this->spawn_cv_.wait(lock, [this]() { return this->num_spawned_ == this->workers_.size(); });
+    }
+  }
+
+  this->Loop(worker);
+  if (this->wif_ != nullptr) {
+    this->wif_->scheduler_epilogue(id);
+  }
+}
+
+inline void Executor::Loop(Worker &w) {
+  ThisWorker() = &w;
+  Node *t = nullptr;
+  for (;;) {
+    this->ExploitTask(w, t);
+    if (!this->WaitForTask(w, t)) {
+      break;
+    }
+  }
+  ThisWorker() = nullptr;
+}
+
+inline void Executor::ExploitTask(Worker &w, Node *&t) {
+  while (t != nullptr) {
+    t = this->Invoke(w, t);
+    if (t == nullptr) {
+      t = this->PopLocal(w);
+    }
+  }
+}
+
+inline bool Executor::WaitForTask(Worker &w, Node *&t) {
+  for (;;) {
+    this->ExploreTask(w, t);
+    if (t != nullptr) {
+      return true;
+    }
+
+    this->notifier_.PrepareWait(w.waiter_);
+
+    if (!this->SharedEmpty()) {
+      this->notifier_.CancelWait(w.waiter_);
+      t = this->StealShared();
+      if (t != nullptr) {
+        return true;
+      }
+      continue;
+    }
+
+    if (this->done_.load(std::memory_order_acquire)) {
+      this->notifier_.CancelWait(w.waiter_);
+      this->notifier_.Notify(true);
+      return false;
+    }
+
+    if (this->HasQueuedTask()) {
+      this->notifier_.CancelWait(w.waiter_);
+      continue;
+    }
+
+    this->Park(w);
+    // I/O事件的回调在本地队列中
+    t = this->PopLocal(w);
+    if (t != nullptr) {
+      return true;
+    }
+  }
+}
+
+inline void Executor::Park(Worker &w) {
+  this->Observe([&w](ObserverInterface &observer) { observer.on_park(w.id_); });
+  if (!this->ParkOnIo(w)) {
+    this->notifier_.CommitWait(w.waiter_);
+  }
+  this->Observe([&w](ObserverInterface &observer) { observer.on_unpark(w.id_); });
+}
+
+inline bool Executor::ParkOnIo(Worker &w) {
+#ifdef __linux__
+  IoContext *io = this->io_.load(std::memory_order_acquire);
+  if (io == nullptr || !io->TryAcquirePoller()) {
+    return false;
+  }
+  this->notifier_.SetExternalPark(w.waiter_, io);
+  this->notifier_.CommitWait(w.waiter_);
+  this->notifier_.SetExternalPark(w.waiter_, nullptr);
+  io->Drain();
+  io->ReleasePoller();
+  return true;
+#else
+  (void)w;
+  return false;
+#endif
+}
+
+inline bool Executor::HasQueuedTask() const {
+  if (!this->SharedEmpty()) {
+    return true;
+  }
+  for (auto &victim : this->workers_) {
+    for (auto &wsq : victim->wsq_) {
+      if (!wsq.Empty()) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+inline bool Executor::SharedEmpty() const {
+  for (auto &wsq : this->wsq_) {
+    if (!wsq.Empty()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// 空队列上的Pop/Steal也要执行一次seq_cst fence，先用Empty()跳过空的优先级
+inline Node *Executor::PopLocal(Worker &w) {
+  for (auto &wsq : w.wsq_) {
+    if (!wsq.Empty()) {
+      if (Node *t = wsq.Pop(); t != nullptr) {
+        return t;
+      }
+    }
+  }
+  return nullptr;
+}
+
+inline Node *Executor::StealShared() {
+  for (auto &wsq : this->wsq_) {
+    if (!wsq.Empty()) {
+      if (Node *t = wsq.Steal(); t != nullptr) {
+        return t;
+      }
+    }
+  }
+  return nullptr;
+}
+
+inline Node *Executor::StealFrom(Worker &w, size_t vtm) {
+  if (vtm == w.id_) {
+    return this->StealShared();
+  }
+  for (auto &wsq : this->workers_[vtm]->wsq_) {
+    if (!wsq.Empty()) {
+      if (Node *t = wsq.Steal(); t != nullptr) {
+        return t;
+      }
+    }
+  }
+  return nullptr;
+}
+
+// 同时有多个Worker在找HIGH任务时各自窃取一次，victim的HIGH队列取空之后才清除提示；
+// CAS失败说明期间有新的HIGH任务入队，保留新的提示
+inline Node *Executor::StealFirst(Worker &w, size_t vtm) {
+  size_t high = this->high_victim_.load(std::memory_order_acquire);
+  if (high != SIZE_MAX && high != w.id_) {
+    auto steal_high = [this, high](auto &wsq) {
+      Node *t = wsq.Empty() ? nullptr : wsq.Steal();
+      if (wsq.Empty()) {
+        size_t expected = high;
+        this->high_victim_.compare_exchange_strong(expected, SIZE_MAX, std::memory_order_relaxed);
+      }
+      return t;
+    };
+    constexpr size_t p = static_cast<size_t>(TaskPriority::HIGH);
+    Node *t = high == this->workers_.size() ? steal_high(this->wsq_[p]) : steal_high(this->workers_[high]->wsq_[p]);
+    if (t != nullptr) {
+      return t;
+    }
+  }
+  return this->StealFrom(w, vtm);
+}
+
+inline bool Executor::MarkHigh(TaskPriority priority, size_t victim) {
+  if (priority != TaskPriority::HIGH) {
+    return false;
+  }
+  this->high_victim_.store(victim, std::memory_order_release);
+  return true;
+}
+
+// 入队的一方不会处于挂起状态，不会选中自己；IsParked为true但NotifyWaiter失败时对方已经被其他通知唤醒，
+// 留下的notified_只让它下一次CommitWait立即返回。
+// 只检查shard中的Worker，其他分片交给Notify(false)，不在每个HIGH任务上遍历所有Worker
+inline void Executor::NotifyHigh(size_t shard) {
+  for (size_t id : this->shard_workers_[shard]) {
+    Worker *worker = this->workers_[id].get();
+    if (this->notifier_.IsParked(worker->waiter_) && this->notifier_.NotifyWaiter(worker->waiter_)) {
+      return;
+    }
+  }
+  this->notifier_.Notify(false, shard);
+}
+
+inline void Executor::NotifyPushed(size_t n, size_t num_high, size_t shard) {
+  for (size_t i = 0; i < num_high; i++) {
+    this->NotifyHigh(shard);
+  }
+  n -= num_high;
+  if (n == 1) {
+    this->notifier_.Notify(false, shard);
+  } else if (n > 1) {
+    this->notifier_.NotifyN(n, shard);
+  }
+}
+
+inline void Executor::ExploreTask(Worker &w, Node *&t) {
+  const size_t num_workers = this->workers_.size();
+  const size_t max_steals = (num_workers + 1) * 2;
+  const size_t max_yields = 100;
+  std::uniform_int_distribution<size_t> rdvtm(0, num_workers - 1);
+
+  size_t num_steals = 0;
+  size_t num_yields = 0;
+  while (!this->done_.load(std::memory_order_relaxed)) {
+    // 随机选中自己时窃取共享队列
+    t = this->StealFirst(w, rdvtm(w.rdgen_));
+    if (t != nullptr) {
+      return;
+    }
+    if (++num_steals > max_steals) {
+      std::this_thread::yield();
+      if (++num_yields > max_yields) {
+        return;
+      }
+    }
+  }
+}
+
+// 每轮先Pop本地队列，为空时随机窃取一次，都没有任务时让出cpu，
+// park为true且连续失败超过max_steals次后PrepareWait，再次检查stop()以及所有队列后挂起
+template <typename P>
+void Executor::CorunUntil(Worker &w, P &&stop, bool park) {
+  const size_t max_steals = (this->workers_.size() + 1) * 2;
+  std::uniform_int_distribution<size_t> rdvtm(0, this->workers_.size() - 1);
+  size_t num_steals = 0;
+  while (!stop()) {
+    Node *t = this->PopLocal(w);
+    if (t == nullptr) {
+      t = this->StealFirst(w, rdvtm(w.rdgen_));
+    }
+    if (t != nullptr) {
+      num_steals = 0;
+      while (t != nullptr) {
+        t = this->Invoke(w, t);
+      }
+      continue;
+    }
+    if (!park || ++num_steals <= max_steals) {
+      std::this_thread::yield();
+      continue;
+    }
+    num_steals = 0;
+    this->notifier_.PrepareWait(w.waiter_);
+    if (stop() || this->HasQueuedTask()) {
+      this->notifier_.CancelWait(w.waiter_);
+      continue;
+    }
+    this->Park(w);
+  }
+}
+
+inline void Executor::CorunGraph(Worker &w, Node *parent, Graph &graph) {
+  const auto &nodes = graph.Nodes();
+  if (nodes.empty()) {
+    return;
+  }
+  Topology *tp = parent->topology_;
+  std::vector<Node *> sources;
+  for (auto node : nodes) {
+    node->topology_ = tp;
+    node->parent_ = parent;
+    node->join_counter_.store(node->num_strong_dependents_, std::memory_order_relaxed);
+    if (node->num_dependents_ == 0) {
+      sources.push_back(node);
+    }
+  }
+  assert(!sources.empty());  // 环必须经过条件任务
+  parent->joiner_ = w.id_;
+  parent->join_counter_.store(sources.size(), std::memory_order_relaxed);
+  // 子任务计入本次运行，父任务完成之前本次运行不会结束
+  tp->join_counter_.fetch_add(sources.size(), std::memory_order_relaxed);
+  this->Schedule(sources.data(), sources.size());
+  this->CorunUntil(
+      w, [parent]() { return parent->join_counter_.load(std::memory_order_acquire) == 0; }, true);
+  graph.Clear();
+}
+
+// 子任务可能在上一次执行的Invoke返回之前被再次调度，topology_与parent_只在这里写一次
+inline void Executor::CorunChildren(Worker &w, Node *parent, Node *const *children, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    children[i]->topology_ = parent->topology_;
+    children[i]->parent_ = parent;
+  }
+  parent->joiner_ = w.id_;
+  parent->join_counter_.store(0, std::memory_order_relaxed);
+  this->SpawnChild(parent, children[0]);
+  this->CorunUntil(
+      w, [parent]() { return parent->join_counter_.load(std::memory_order_acquire) == 0; }, true);
+}
+
+// 与CorunGraph相同，只是源点与计数来自module的一个Topology，运行结束后归还给module
+inline void Executor::CorunModule(Subflow &sf, Taskflow &module) {
+  if (module.empty()) {
+    return;
+  }
+  Worker &w = *this->workers_[sf.worker_id_];
+  Node *parent = sf.parent_;
+  Topology *frame = module.AcquireTopology();
+  frame->executor_ = this;
+  this->BindTopology(frame, parent->topology_, parent);
+  const size_t num_sources = frame->sources_.size();
+  parent->joiner_ = w.id_;
+  parent->join_counter_.store(num_sources, std::memory_order_relaxed);
+  parent->topology_->join_counter_.fetch_add(num_sources, std::memory_order_relaxed);
+  this->Schedule(frame->sources_.data(), num_sources);
+  this->CorunUntil(
+      w, [parent]() { return parent->join_counter_.load(std::memory_order_acquire) == 0; }, true);
+  module.ReleaseTopology(frame);
+}
+
+// 调用方仍在计数中，两个计数在这里不会先减到0
+inline void Executor::SpawnChild(Node *parent, Node *child) {
+  parent->join_counter_.fetch_add(1, std::memory_order_relaxed);
+  parent->topology_->join_counter_.fetch_add(1, std::memory_order_relaxed);
+  this->Schedule(child);
+}
+
+inline void Executor::Schedule(Node *node) { this->Schedule(&node, 1); }
+
+inline void Executor::Schedule(Node *const *nodes, size_t n) {
+  if (n == 0) {
+    return;
+  }
+  size_t num_high = 0;
+  Worker *w = ThisWorker();
+  if (w != nullptr && w->executor_ == this) {
+    for (size_t i = 0; i < n; i++) {
+      num_high += this->PushLocal(*w, nodes[i]);
+    }
+  } else {
+    std::lock_guard<std::mutex> lock(this->wsq_mutex_);
+    for (size_t i = 0; i < n; i++) {
+      Node *node = nodes[i];
+      const TaskPriority priority = node->priority_;
+      this->wsq_[static_cast<size_t>(priority)].Push(node);
+      num_high += this->MarkHigh(priority, this->workers_.size());
+    }
+  }
+  this->NotifyPushed(n, num_high, this->HomeShard());
+}
+
+inline bool Executor::PushLocal(Worker &w, Node *node) {
+  const TaskPriority priority = node->priority_;
+  const size_t p = static_cast<size_t>(priority);
+  if (w.wsq_[p].TryPush(node)) {
+    return this->MarkHigh(priority, w.id_);
+  }
+  std::lock_guard<std::mutex> lock(this->wsq_mutex_);
+  this->wsq_[p].Push(node);
+  return this->MarkHigh(priority, this->workers_.size());
+}
+
+inline Node *Executor::Invoke(Worker &w, Node *node) {
+  Node *def = node->Origin();
+  auto on_entry = [&w, def](ObserverInterface &observer) { observer.on_entry(w.id_, TaskView(*def)); };
+  auto on_exit = [&w, def](ObserverInterface &observer) { observer.on_exit(w.id_, TaskView(*def)); };
+
+  Topology *tp = node->topology_;
+  if (tp == nullptr) {
+    this->Observe(on_entry);
+    node->Run();
+    this->Observe(on_exit);
+    ObjectPool<Node>::Instance().Recycle(node);
+    this->DecrementTopology();
+    return nullptr;
+  }
+
+  bool skip = tp->cancelled_.load(std::memory_order_relaxed);
+  if (!skip && def->semaphores_ != nullptr) {
+    if (!this->AcquireSemaphores(w, node)) {
+      return nullptr;
+    }
+    // 等待Semaphore期间可能已经取消，取消之后只能由SettleCancelled代为归还不成对的获取
+    skip = tp->cancelled_.load(std::memory_order_relaxed);
+    if (skip) {
+      this->ReturnSemaphores(w, node);
+    } else if (!def->semaphores_->paired_) {
+      this->CountHeld(tp, *def->semaphores_);
+    }
+  }
+
+  Node *cache = nullptr;
+  Node *parent = node->parent_;
+  if (skip) {
+    // 跳过的Node相当于没有后继的空任务，不获取也不归还Semaphore；它可能是被Semaphore唤醒的，把唤醒交给下一个
+    if (def->semaphores_ != nullptr) {
+      this->HandoffSemaphores(w, node);
+    }
+  } else if (def->type_ == Node::Type::CONDITION) {
+    this->Observe(on_entry);
+    int idx = def->work_(nullptr);
+    this->Observe(on_exit);
+    if (def->semaphores_ != nullptr) {
+      this->ReleaseSemaphores(w, node);
+    }
+    // 环上的下一轮迭代从这里开始重新计数
+    node->join_counter_.store(def->num_strong_dependents_, std::memory_order_relaxed);
+    if (idx >= 0 && static_cast<size_t>(idx) < def->successors_.size()) {
+      cache = node->Resolve(def->successors_[idx]);
+    }
+  } else {
+    this->Observe(on_entry);
+    if (def->type_ == Node::Type::SUBFLOW) {
+      Subflow sf(*this, w.id_, node);
+      def->work_(&sf);
+      if (sf.joinable()) {
+        sf.join();
+      }
+    } else {
+      def->Run();
+    }
+    this->Observe(on_exit);
+    // 在减少后继的计数之前归还，环上的下一轮迭代可能在其他Worker上再次获取
+    if (def->semaphores_ != nullptr) {
+      this->ReleaseSemaphores(w, node);
+    }
+    // Subflow期间join_counter_被用于子任务计数，执行完之后再重置
+    node->join_counter_.store(def->num_strong_dependents_, std::memory_order_relaxed);
+    for (auto s : def->successors_) {
+      Node *succ = node->Resolve(s);
+      if (succ->join_counter_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        if (cache == nullptr) {
+          cache = succ;
+        } else if (succ->priority_ < cache->priority_) {
+          w.ready_.push_back(cache);
+          cache = succ;
+        } else {
+          w.ready_.push_back(succ);
+        }
+      }
+    }
+  }
+
+  // cache接替当前Node在计数中的位置，其余就绪的后继先计数再入队，计数不会提前减到0
+  if (cache != nullptr) {
+    const size_t num_ready = w.ready_.size();
+    if (num_ready > 0) {
+      tp->join_counter_.fetch_add(num_ready, std::memory_order_relaxed);
+      if (parent != nullptr) {
+        parent->join_counter_.fetch_add(num_ready, std::memory_order_relaxed);
+      }
+      size_t num_high = 0;
+      for (auto succ : w.ready_) {
+        num_high += this->PushLocal(w, succ);
+      }
+      w.ready_.clear();
+      this->NotifyPushed(num_ready, num_high, w.shard_);
+    }
+    return cache;
+  }
+
+  // 计数减少之后tp可能已经结束，在这之前检查
+  this->SettleCancelled(w, tp, 1);
+  if (tp->join_counter_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    this->TearDownTopology(tp);
+  }
+  // 父任务被唤醒后会回收node，之后不能再访问node
+  if (parent != nullptr) {
+    size_t joiner = parent->joiner_;
+    if (parent->join_counter_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      this->notifier_.NotifyWaiter(this->workers_[joiner]->waiter_);
+    }
+  }
+  return nullptr;
+}
+
+// 获取第i个失败时先归还前i个，再挂到第i个的等待队列上
+inline bool Executor::AcquireSemaphores(Worker &w, Node *node) {
+  const auto &semaphores = node->Origin()->semaphores_->to_acquire_;
+  for (size_t i = 0; i < semaphores.size();) {
+    if (semaphores[i]->TryAcquire()) {
+      i++;
+      continue;
+    }
+    for (size_t j = 0; j < i; j++) {
+      this->ResumeWaiter(w, semaphores[j]->Release());
+    }
+    if (this->WaitSemaphore(w, semaphores[i], node)) {
+      return false;
+    }
+    i = 0;
+  }
+  return true;
+}
+
+inline void Executor::ReleaseSemaphores(Worker &w, Node *node) {
+  for (auto semaphore : node->Origin()->semaphores_->to_release_) {
+    this->ResumeWaiter(w, semaphore->Release());
+  }
+}
+
+inline void Executor::ReturnSemaphores(Worker &w, Node *node) {
+  for (auto semaphore : node->Origin()->semaphores_->to_acquire_) {
+    this->ResumeWaiter(w, semaphore->Release());
+  }
+}
+
+inline void Executor::HandoffSemaphores(Worker &w, Node *node) {
+  for (auto semaphore : node->Origin()->semaphores_->to_acquire_) {
+    this->ResumeWaiter(w, semaphore->Handoff());
+  }
+}
+
+// 执行之前一次记入获取与归还，执行期间本次运行一直有正在执行的Node，SettleCancelled不会看到中间状态
+inline void Executor::CountHeld(Topology *tp, const NodeSemaphores &semaphores) {
+  std::lock_guard<std::mutex> lock(tp->semaphore_mutex_);
+  auto add = [tp](Semaphore *semaphore, int64_t n) {
+    for (auto &held : tp->held_) {
+      if (held.first == semaphore) {
+        held.second += n;
+        return;
+      }
+    }
+    tp->held_.emplace_back(semaphore, n);
+  };
+  for (auto semaphore : semaphores.to_acquire_) {
+    add(semaphore, 1);
+  }
+  for (auto semaphore : semaphores.to_release_) {
+    add(semaphore, -1);
+  }
+}
+
+// 挂起之前计入等待数量：node挂起之后可能立即被唤醒并结束本次运行，之后不能再访问tp。
+// node可能是本次运行最后一个正在执行的Node，挂起之前先检查是否需要代为归还，归还之后Wait不再挂起
+inline bool Executor::WaitSemaphore(Worker &w, Semaphore *semaphore, Node *node) {
+  Topology *tp = node->topology_;
+  {
+    std::lock_guard<std::mutex> lock(tp->semaphore_mutex_);
+    tp->num_semaphore_waiters_++;
+  }
+  this->SettleCancelled(w, tp, 0);
+  if (semaphore->Wait(node)) {
+    return true;
+  }
+  std::lock_guard<std::mutex> lock(tp->semaphore_mutex_);
+  tp->num_semaphore_waiters_--;
+  return false;
+}
+
+// 满足条件时之后执行的Node都会被跳过，held_中剩余的数量不会再有Node归还；
+// 在semaphore_mutex_内取走held_，多个调用者同时满足条件时只归还一次
+inline void Executor::SettleCancelled(Worker &w, Topology *tp, size_t self) {
+  if (!tp->cancelled_.load(std::memory_order_relaxed)) {
+    return;
+  }
+  std::vector<std::pair<Semaphore *, int64_t>> held;
+  {
+    std::lock_guard<std::mutex> lock(tp->semaphore_mutex_);
+    if (tp->held_.empty() ||
+        tp->join_counter_.load(std::memory_order_acquire) != tp->num_semaphore_waiters_ + self) {
+      return;
+    }
+    held.swap(tp->held_);
+  }
+  for (auto &[semaphore, n] : held) {
+    for (; n > 0; n--) {
+      this->ResumeWaiter(w, semaphore->Release());
+    }
+  }
+}
+
+// 被唤醒的node仍然计入所属的Topology，此时还不能结束，可以访问node->topology_
+inline void Executor::ResumeWaiter(Worker &w, Node *node) {
+  if (node != nullptr) {
+    {
+      Topology *tp = node->topology_;
+      std::lock_guard<std::mutex> lock(tp->semaphore_mutex_);
+      tp->num_semaphore_waiters_--;
+    }
+    this->NotifyPushed(1, this->PushLocal(w, node), w.shard_);
+  }
+}
+
+inline RunFuture Executor::run(Taskflow &taskflow) { return this->run_n(taskflow, 1); }
+
+inline RunFuture Executor::run_n(Taskflow &taskflow, size_t n) {
+  if (n == 0 || taskflow.empty()) {
+    return RunFuture();
+  }
+  Topology *tp = taskflow.AcquireTopology();
+  uint64_t ticket = 0;
+  {
+    std::lock_guard<std::mutex> lock(tp->mutex_);
+    tp->executor_ = this;
+    tp->num_submitted_ += n;
+    ticket = tp->num_submitted_;
+  }
+  this->num_topologies_.fetch_add(n, std::memory_order_relaxed);
+  this->SetupTopology(tp);
+  return RunFuture(tp, ticket);
+}
+
+inline void Executor::SetupTopology(Topology *tp) {
+  this->BindTopology(tp, tp, nullptr);
+  tp->join_counter_.store(tp->sources_.size(), std::memory_order_relaxed);
+  this->Schedule(tp->sources_.data(), tp->sources_.size());
+}
+
+// 实例数量跟随Graph的大小，每次都重新写origin_，Taskflow在两次运行之间被修改过也没有关系
+inline void Executor::BindTopology(Topology *frame, Topology *tp, Node *parent) {
+  const auto &nodes = frame->taskflow_.graph_.Nodes();
+  const size_t num_nodes = nodes.size();
+  auto &instances = frame->instances_;
+  if (!frame->primary_) {
+    auto &pool = ObjectPool<Node>::Instance();
+    while (instances.size() > num_nodes) {
+      pool.Recycle(instances.back());
+      instances.pop_back();
+    }
+    while (instances.size() < num_nodes) {
+      instances.push_back(pool.Animate());
+    }
+  }
+  frame->sources_.clear();
+  for (size_t i = 0; i < num_nodes; i++) {
+    Node *def = nodes[i];
+    Node *node = def;
+    if (!frame->primary_) {
+      node = instances[i];
+      node->origin_ = def;
+      node->siblings_ = instances.data();
+      node->priority_ = def->priority_;
+    }
+    node->topology_ = tp;
+    node->parent_ = parent;
+    node->join_counter_.store(def->num_strong_dependents_, std::memory_order_relaxed);
+    if (def->num_dependents_ == 0) {
+      frame->sources_.push_back(node);
+    }
+  }
+  assert(!frame->sources_.empty());  // 环必须经过条件任务
+}
+
+inline void Executor::TearDownTopology(Topology *tp) {
+  bool more = false;
+  uint64_t skipped = 0;
+  {
+    std::lock_guard<std::mutex> lock(tp->mutex_);
+    tp->num_finished_++;
+    // 本次运行已经没有Node，不需要semaphore_mutex_；没有取消时剩余的数量留给Semaphore自己管理
+    tp->held_.clear();
+    if (tp->cancelled_.load(std::memory_order_relaxed)) {
+      // run_n剩余的运行直接算作完成
+      skipped = tp->num_submitted_ - tp->num_finished_;
+      tp->num_finished_ = tp->num_submitted_;
+      tp->cancelled_.store(false, std::memory_order_relaxed);
+    }
+    more = tp->num_finished_ < tp->num_submitted_;
+    if (!more) {
+      // 在唤醒等待者之前归还，下一次运行取走tp之后要先获得tp->mutex_才能修改计数
+      tp->taskflow_.ReleaseTopology(tp);
+      // 解锁之后Taskflow可能被销毁，不能再访问tp
+      tp->cv_.notify_all();
+    }
+  }
+  if (more) {
+    this->SetupTopology(tp);
+  }
+  this->DecrementTopology(1 + skipped);
+}
+
+inline void Executor::DecrementTopology(size_t n) {
+  if (this->num_topologies_.fetch_sub(n, std::memory_order_acq_rel) == n) {
+    // 加锁保证wait_for_all不会在检查条件与进入等待之间错过通知
+    { std::lock_guard<std::mutex> lock(this->topology_mutex_); }
+    this->topology_cv_.notify_all();
+  }
+}
+
+// 在tp->mutex_内检查与设置，运行结束后Topology可能已经被下一次运行取走，不能再修改cancelled_
+inline bool RunFuture::cancel() {
+  if (this->topology_ == nullptr) {
+    return false;
+  }
+  Executor *executor = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(this->topology_->mutex_);
+    if (this->topology_->num_finished_ >= this->ticket_) {
+      return false;
+    }
+    this->topology_->cancelled_.store(true, std::memory_order_relaxed);
+    if (this->topology_->join_counter_.load(std::memory_order_relaxed) > 0) {
+      executor = this->topology_->executor_;
+    }
+  }
+  // Executor的生命周期覆盖所有运行，解锁之后只访问executor
+  if (executor != nullptr) {
+    executor->notifier_.Notify(true);
+  }
+  return true;
+}
+
+inline Task FlowBuilder::composed_of(Taskflow &taskflow) {
+  return this->emplace([&taskflow](Subflow &sf) { sf.executor().CorunModule(sf, taskflow); });
+}
+
+inline void Subflow::join() {
+  assert(this->joinable());
+  this->joined_ = true;
+  this->executor_.CorunGraph(*this->executor_.workers_[this->worker_id_], this->parent_, this->graph_);
+}
+
+template <typename R>
+void AsyncFuture<R>::wait() const {
+  if (this->ready()) {
+    return;
+  }
+  Executor *executor = this->state_->executor_;
+  Executor::Worker *w = Executor::ThisWorker();
+  if (w != nullptr && w->executor_ == executor) {
+    executor->CorunUntil(
+        *w, [this]() { return this->state_->Ready(); }, false);
+  } else {
+    this->state_->Wait();
+  }
+}
+
+#ifdef __linux__
+// 已经挂起的Worker不会去竞争polling_，唤醒一个让它接替epoll_wait
+inline IoContext &Executor::io() {
+  if (IoContext *io = this->io_.load(std::memory_order_acquire); io != nullptr) {
+    return *io;
+  }
+  std::lock_guard<std::mutex> lock(this->io_mutex_);
+  if (this->io_owner_ == nullptr) {
+    this->io_owner_ = std::make_unique<IoContext>(*this);
+    this->io_.store(this->io_owner_.get(), std::memory_order_release);
+    this->notifier_.Notify(false);
+  }
+  return *this->io_owner_;
+}
+
+// 在Worker线程上调用，回调通过silent_async进入这个Worker的本地队列
+inline void IoContext::Drain() {
+  if (this->ready_.empty()) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    for (auto &[fd, events] : this->ready_) {
+      // 已经被cancel的fd没有回调
+      if (auto it = this->pending_.find(fd); it != this->pending_.end()) {
+        this->fired_.emplace_back(std::move(it->second), events);
+        this->pending_.erase(it);
+      }
+    }
+  }
+  this->ready_.clear();
+  for (auto &[callback, events] : this->fired_) {
+    this->executor_.silent_async([callback = std::move(callback), events = events]() mutable { callback(events); });
+  }
+  this->fired_.clear();
+}
+#endif
+
+template <typename R>
+void AsyncState<R>::ResumeAwaiter() {
+  this->executor_->silent_async([resume = this->resume_, awaiter = this->awaiter_]() { resume(awaiter); });
+}
+
+template <typename R>
+R AsyncFuture<R>::get() {
+  assert(this->valid());
+  this->wait();
+  AsyncState<R> *state = std::exchange(this->state_, nullptr);
+  if (state->exception_) {
+    std::exception_ptr e = std::move(state->exception_);
+    state->Release();
+    std::rethrow_exception(e);
+  }
+  if constexpr (std::is_void_v<R>) {
+    state->Release();
+  } else {
+    R value = std::move(*state->value_);
+    state->Release();
+    return value;
+  }
+}
+
+}  // namespace shanzhai_tf
@@ -0,0 +1,126 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "taskflow/algorithm/partitioner.hpp"
+#include "taskflow/core/graph.hpp"
+#include "taskflow/core/task.hpp"
+
+namespace shanzhai_tf {
+
+class Executor;
+class Pipeline;
+class Taskflow;
+
+/*
+向Graph中添加任务的接口，参数为Subflow&的callable会在运行时创建子任务图
+（1）并行算法定义在taskflow/algorithm/下，每个算法是一个在运行时创建子任务的Task，
+   迭代器必须是随机访问迭代器，first/last等参数按值保存，每次运行时重新读取
+*/
+class FlowBuilder {
+ public:
+  // 添加一个任务，返回int的callable是条件任务，返回值选择执行哪个后继
+  template <typename C>
+  Task emplace(C &&callable);
+
+  // 添加多个任务，返回std::tuple<Task...>
+  template <typename... C, std::enable_if_t<(sizeof...(C) > 1), void> * = nullptr>
+  auto emplace(C &&...callables);
+
+  // 添加一个空任务，只用于连接依赖关系
+  Task placeholder();
+
+  // 对first, first + step, ...（不包括last）调用callable(i)，step可以为负
+  template <typename B, typename E, typename S, typename C, typename P = DefaultPartitioner>
+  Task for_each_index(B first, E last, S step, C callable, P part = P());
+
+  // *(d_first + i) = callable(*(first + i))
+  template <typename B, typename E, typename O, typename C, typename P = DefaultPartitioner>
+  Task transform(B first, E last, O d_first, C callable, P part = P());
+
+  // init = bop(init, ...)，bop必须满足结合律和交换律，运行结束前不能访问init
+  template <typename B, typename E, typename T, typename BOP, typename P = DefaultPartitioner>
+  Task reduce(B first, E last, T &init, BOP bop, P part = P());
+
+  // init = bop(init, uop(*it)...)
+  template <typename B, typename E, typename T, typename BOP, typename UOP, typename P = DefaultPartitioner>
+  Task transform_reduce(B first, E last, T &init, BOP bop, UOP uop, P part = P());
+
+  // 结果写到d_first，d_first可以等于first，bop必须满足结合律
+  template <typename B, typename E, typename D, typename BOP>
+  Task inclusive_scan(B first, E last, D d_first, BOP bop);
+
+  // 不稳定排序
+  template <typename B, typename E, typename C = std::less<>>
+  Task sort(B first, E last, C cmp = C());
+
+  // 运行pipeline的Task，pipeline的生命周期由调用者保证，定义在taskflow/algorithm/pipeline.hpp
+  Task composed_of(Pipeline &pipeline);
+
+  // 就地运行taskflow的模块任务，不复制taskflow，taskflow的生命周期由调用者保证，定义在executor.hpp；
+  // 同一个taskflow可以被多个模块任务同时运行，但不能直接或间接地包含自己
+  Task composed_of(Taskflow &taskflow);
+
+ protected:
+  explicit FlowBuilder(Graph &graph) : graph_(graph) {}
+
+  Graph &graph_;
+};
+
+template <typename C>
+Task FlowBuilder::emplace(C &&callable) {
+  return Task(this->graph_.Emplace(std::forward<C>(callable)));
+}
+
+template <typename... C, std::enable_if_t<(sizeof...(C) > 1), void> *>
+auto FlowBuilder::emplace(C &&...callables) {
+  return std::make_tuple(this->emplace(std::forward<C>(callables))...);
+}
+
+inline Task FlowBuilder::placeholder() { return Task(this->graph_.Emplace()); }
+
+/*
+运行时创建的子任务图，只在父任务执行期间存在
+（1）父任务返回时如果还没有join，Executor自动join
+（2）join期间当前Worker执行本地队列以及窃取到的任务，没有任何任务时才在Notifier上挂起，
+   最后一个子任务完成时通过NotifyWaiter唤醒它
+（3）子任务执行完之后随Subflow一起回收，父任务每次运行都会重新创建
+*/
+class Subflow : public FlowBuilder {
+  friend class Executor;
+  friend class Pipeline;
+
+ public:
+  Subflow(const Subflow &) = delete;
+  Subflow &operator=(const Subflow &) = delete;
+
+  // 运行所有子任务并等待它们完成，只能调用一次，定义在executor.hpp
+  void join();
+  bool joinable() const { return !this->joined_; }
+
+  size_t num_tasks() const { return this->graph_.Size(); }
+
+  Executor &executor() { return this->executor_; }
+
+ private:
+  Subflow(Executor &executor, size_t worker_id, Node *parent)
+      : FlowBuilder(graph_), executor_(executor), worker_id_(worker_id), parent_(parent) {}
+
+  Graph graph_{};
+  Executor &executor_;
+  size_t worker_id_{0};
+  Node *parent_{nullptr};
+  bool joined_{false};
+};
+
+}  // namespace shanzhai_tf
@@ -0,0 +1,261 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "taskflow/core/object_pool.hpp"
+#include "taskflow/core/small_function.hpp"
+
+// Node内联保存可调用对象的字节数，可配置为48到128，
+// 默认值刚好放下64字节的lambda加上async结果的指针
+#ifndef SHANZHAI_TF_TASK_INLINE_SIZE
+#define SHANZHAI_TF_TASK_INLINE_SIZE 72
+#endif
+
+static_assert(SHANZHAI_TF_TASK_INLINE_SIZE >= 48 && SHANZHAI_TF_TASK_INLINE_SIZE <= 128,
+              "SHANZHAI_TF_TASK_INLINE_SIZE must be in [48, 128]");
+
+namespace shanzhai_tf {
+
+class Executor;
+class FlowBuilder;
+class Graph;
+class Semaphore;
+class Subflow;
+class Task;
+class Topology;
+
+// 构造async Node的标记，返回值被忽略，不会被当作条件任务
+struct AsyncWorkTag {};
+
+// 任务优先级，数值越小越优先，每个Worker为每个优先级维护一个本地队列
+enum class TaskPriority : unsigned {
+  HIGH = 0,
+  NORMAL = 1,
+  LOW = 2,
+  MAX = 3,
+};
+
+inline constexpr size_t kNumTaskPriorities = static_cast<size_t>(TaskPriority::MAX);
+
+class Node;
+
+// Node执行前获取、执行后归还的Semaphore，只有声明了acquire/release的Node才分配
+struct NodeSemaphores {
+  std::vector<Semaphore *> to_acquire_{};
+  std::vector<Semaphore *> to_release_{};
+  // 两者包含相同的Semaphore（不计顺序），执行时总是成对获取与归还，取消时不需要记入Topology
+  bool paired_{true};
+};
+
+/*
+Executor调度的最小单位
+（1）三种任务统一包装为SmallFunction<int(Subflow *)>保存在work_，type_区分它们；
+   可调用对象不超过SHANZHAI_TF_TASK_INLINE_SIZE字节时直接构造在Node内部，否则在堆上分配，
+   只能移动的可调用对象也可以作为任务；
+   async/silent_async提交的Node没有topology_，执行完即销毁
+（2）Graph中的Node属于某个Taskflow，可以重复运行：
+   num_dependents_是静态的前驱数量，join_counter_重置为num_strong_dependents_，
+   前驱完成时减一，减到0说明可以执行，重复运行不需要分配内存
+（3）参数为Subflow&的任务（SUBFLOW）运行时创建的子Node的parent_指向它，
+   父Node在等待子Node期间复用join_counter_记录未完成的子Node数量，joiner_为等待它们的Worker
+（4）返回int的任务是条件任务（CONDITION），返回值i选择successors_[i]直接执行，
+   越界时不执行任何后继；条件任务到后继是弱依赖，不计入num_strong_dependents_，
+   因此图中可以有经过条件任务的环，只有弱依赖的Node不是源点
+（5）priority_决定Node进入哪个优先级的队列，默认为NORMAL
+（6）semaphores_不为空时Executor在执行前后获取与归还其中的Semaphore，见semaphore.hpp
+（7）同一个Graph同时运行多次或者作为模块使用时，除了第一次以外的运行使用实例Node（见topology.hpp）：
+   实例只有join_counter_、topology_、parent_等运行时状态，origin_指向Graph中定义它的Node，
+   可调用对象、后继等都从origin_读取，后继的实例为siblings_[后继的index_]
+*/
+class Node {
+  friend class Executor;
+  friend class FlowBuilder;
+  friend class Graph;
+  friend class Semaphore;
+  friend class Task;
+  friend class TaskView;
+
+ public:
+  Node() = default;
+
+  template <typename C>
+  explicit Node(C &&c);
+
+  template <typename C>
+  Node(AsyncWorkTag, C &&c);
+
+  Node(const Node &) = delete;
+  Node &operator=(const Node &) = delete;
+
+ private:
+  enum class Type : uint8_t {
+    STATIC,
+    SUBFLOW,
+    CONDITION,
+  };
+
+  // STATIC与SUBFLOW任务返回-1，SUBFLOW任务的参数不为空
+  using Work = SmallFunction<int(Subflow *), SHANZHAI_TF_TASK_INLINE_SIZE>;
+
+  template <typename C>
+  static constexpr Type TypeOf();
+  // 直接构造在work_中，避免移动SmallFunction时按字节拷贝未初始化的storage_
+  template <typename C>
+  static Work MakeWork(C &&c);
+
+  void Precede(Node *v);
+  // 执行STATIC任务，占位Node什么也不做
+  void Run();
+
+  // 实例返回定义它的Node，否则返回this
+  Node *Origin() { return this->origin_ != nullptr ? this->origin_ : this; }
+  // origin_的后继succ在同一次运行中对应的Node
+  Node *Resolve(Node *succ) const { return this->siblings_ != nullptr ? this->siblings_[succ->index_] : succ; }
+
+  std::string name_{};
+  Work work_{};
+  Type type_{Type::STATIC};
+  std::vector<Node *> successors_{};
+  size_t num_dependents_{0};
+  size_t num_strong_dependents_{0};
+  TaskPriority priority_{TaskPriority::NORMAL};
+  std::atomic<size_t> join_counter_{0};
+  Topology *topology_{nullptr};
+  Node *parent_{nullptr};
+  size_t joiner_{0};
+  std::unique_ptr<NodeSemaphores> semaphores_{};
+  Node *next_waiter_{nullptr};  // 挂起时在Semaphore等待队列中的下一个Node
+  size_t index_{0};             // 在所属Graph中的下标
+  Node *origin_{nullptr};
+  Node *const *siblings_{nullptr};
+};
+
+template <typename C>
+constexpr Node::Type Node::TypeOf() {
+  using F = std::decay_t<C>;
+  if constexpr (std::is_invocable_v<F &, Subflow &>) {
+    return Type::SUBFLOW;
+  } else if constexpr (std::is_same_v<std::invoke_result_t<F &>, int>) {
+    return Type::CONDITION;
+  } else {
+    return Type::STATIC;
+  }
+}
+
+// 包装用的lambda只捕获c，大小与c相同
+template <typename C>
+Node::Work Node::MakeWork(C &&c) {
+  constexpr Type type = TypeOf<C>();
+  if constexpr (type == Type::SUBFLOW) {
+    return Work([f = std::forward<C>(c)](Subflow *sf) mutable -> int {
+      f(*sf);
+      return -1;
+    });
+  } else if constexpr (type == Type::CONDITION) {
+    return Work([f = std::forward<C>(c)](Subflow *) mutable -> int { return f(); });
+  } else {
+    return Work([f = std::forward<C>(c)](Subflow *) mutable -> int {
+      f();
+      return -1;
+    });
+  }
+}
+
+template <typename C>
+Node::Node(C &&c) : work_(MakeWork(std::forward<C>(c))), type_(TypeOf<C>()) {}
+
+template <typename C>
+Node::Node(AsyncWorkTag, C &&c)
+    : work_([f = std::forward<C>(c)](Subflow *) mutable -> int {
+        f();
+        return -1;
+      }) {}
+
+inline void Node::Run() {
+  if (this->work_) {
+    this->work_(nullptr);
+  }
+}
+
+inline void Node::Precede(Node *v) {
+  this->successors_.push_back(v);
+  v->num_dependents_++;
+  if (this->type_ != Type::CONDITION) {
+    v->num_strong_dependents_++;
+  }
+}
+
+/*
+Node的容器，负责Node的生命周期，Node从ObjectPool<Node>分配
+*/
+class Graph {
+ public:
+  Graph() = default;
+  ~Graph();
+
+  Graph(const Graph &) = delete;
+  Graph &operator=(const Graph &) = delete;
+  Graph(Graph &&other) noexcept;
+  Graph &operator=(Graph &&other) noexcept;
+
+  template <typename... ArgsT>
+  Node *Emplace(ArgsT &&...args);
+
+  void Clear();
+  size_t Size() const;
+  bool Empty() const;
+  const std::vector<Node *> &Nodes() const;
+
+ private:
+  std::vector<Node *> nodes_{};
+};
+
+inline Graph::~Graph() { this->Clear(); }
+
+inline Graph::Graph(Graph &&other) noexcept : nodes_(std::move(other.nodes_)) { other.nodes_.clear(); }
+
+inline Graph &Graph::operator=(Graph &&other) noexcept {
+  if (this != &other) {
+    this->Clear();
+    this->nodes_ = std::move(other.nodes_);
+    other.nodes_.clear();
+  }
+  return *this;
+}
+
+template <typename... ArgsT>
+Node *Graph::Emplace(ArgsT &&...args) {
+  Node *node = ObjectPool<Node>::Instance().Animate(std::forward<ArgsT>(args)...);
+  node->index_ = this->nodes_.size();
+  this->nodes_.push_back(node);
+  return node;
+}
+
+inline void Graph::Clear() {
+  auto &pool = ObjectPool<Node>::Instance();
+  for (auto node : this->nodes_) {
+    pool.Recycle(node);
+  }
+  this->nodes_.clear();
+}
+
+inline size_t Graph::Size() const { return this->nodes_.size(); }
+
+inline bool Graph::Empty() const { return this->nodes_.empty(); }
+
+inline const std::vector<Node *> &Graph::Nodes() const { return this->nodes_; }
+
+}  // namespace shanzhai_tf
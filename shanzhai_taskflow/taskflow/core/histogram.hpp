@@ -0,0 +1,106 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace shanzhai_tf {
+
+/*
+对数-线性分桶的直方图（HDR风格，2位有效数字）
+（1）v < 4 时每个值一个桶
+（2）v >= 4 时按最高位分段，每段再按最高位之后的2位分成4个桶，相对误差不超过25%
+（3）Record只在一个线程中调用，其他线程可以随时Snapshot
+*/
+class HistogramData {
+ public:
+  static constexpr size_t kBuckets = 252;
+
+  static size_t BucketOf(uint64_t v);
+  static uint64_t LowerBound(size_t idx);
+
+  void Merge(const HistogramData &other);
+  uint64_t Count() const;
+  // 返回第p（0~100）百分位所在桶的下界
+  uint64_t Percentile(double p) const;
+
+  std::array<uint64_t, kBuckets> counts_{};
+};
+
+inline size_t HistogramData::BucketOf(uint64_t v) {
+  if (v < 4) {
+    return static_cast<size_t>(v);
+  }
+  size_t msb = 63 - static_cast<size_t>(__builtin_clzll(v));
+  size_t sub = static_cast<size_t>((v >> (msb - 2)) & 3);
+  return (msb - 1) * 4 + sub;
+}
+
+inline uint64_t HistogramData::LowerBound(size_t idx) {
+  if (idx < 4) {
+    return idx;
+  }
+  size_t msb = idx / 4 + 1;
+  uint64_t sub = idx % 4;
+  return (4 + sub) << (msb - 2);
+}
+
+inline void HistogramData::Merge(const HistogramData &other) {
+  for (size_t i = 0; i < kBuckets; i++) {
+    this->counts_[i] += other.counts_[i];
+  }
+}
+
+inline uint64_t HistogramData::Count() const {
+  uint64_t count = 0;
+  for (auto c : this->counts_) {
+    count += c;
+  }
+  return count;
+}
+
+inline uint64_t HistogramData::Percentile(double p) const {
+  uint64_t count = this->Count();
+  if (count == 0) {
+    return 0;
+  }
+  uint64_t target = static_cast<uint64_t>(static_cast<double>(count) * p / 100.0);
+  if (target >= count) {
+    target = count - 1;
+  }
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBuckets; i++) {
+    seen += this->counts_[i];
+    if (seen > target) {
+      return LowerBound(i);
+    }
+  }
+  return LowerBound(kBuckets - 1);
+}
+
+class Histogram {
+ public:
+  void Record(uint64_t v) {
+    this->counts_[HistogramData::BucketOf(v)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  HistogramData Snapshot() const {
+    HistogramData data;
+    for (size_t i = 0; i < HistogramData::kBuckets; i++) {
+      data.counts_[i] = this->counts_[i].load(std::memory_order_relaxed);
+    }
+    return data;
+  }
+
+ private:
+  std::array<std::atomic<uint64_t>, HistogramData::kBuckets> counts_{};
+};
+
+}  // namespace shanzhai_tf
@@ -0,0 +1,234 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#ifdef __linux__
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <system_error>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "taskflow/core/notifier.hpp"
+#include "taskflow/core/small_function.hpp"
+
+namespace shanzhai_tf {
+
+class Executor;
+class IoContext;
+
+/*
+co_await io.readable(fd)/io.writable(fd)的返回值，结果为epoll事件（EPOLLIN、EPOLLHUP等）
+*/
+class IoAwaiter {
+ public:
+  IoAwaiter(IoContext &io, int fd, uint32_t events) : io_(io), fd_(fd), events_(events) {}
+
+  bool await_ready() const noexcept { return false; }
+  template <typename H>
+  void await_suspend(H h);
+  uint32_t await_resume() const noexcept { return this->result_; }
+
+ private:
+  IoContext &io_;
+  int fd_;
+  uint32_t events_;
+  uint32_t result_{0};
+};
+
+/*
+epoll与Executor的集成，通过Executor::io()创建
+（1）on_readable/on_writable以EPOLLONESHOT注册fd，事件发生后回调只执行一次，继续等待时重新注册；
+   同一个fd同时只能有一个等待，fd关闭之前没有触发的等待需要cancel
+（2）没有单独的I/O线程：空闲的Worker挂起时先竞争polling_，拿到的Worker通过ExternalPark
+   阻塞在epoll_wait上，Notifier唤醒它时写event_fd_打断epoll_wait；其余Worker照常挂起在Notifier上
+（3）epoll_wait因为fd事件返回时，Worker从Notifier的等待栈中删除自己，在同一个线程把回调作为任务
+   放入自己的本地队列并立即执行，不经过其他线程
+（4）所有Worker都在执行任务时没有Worker阻塞在epoll_wait上，事件在下一个Worker空闲时处理；
+   等待中的fd不计入wait_for_all，回调被调度之后才计入
+*/
+class IoContext : public ExternalPark {
+  friend class Executor;
+  friend class IoAwaiter;
+
+ public:
+  using Callback = SmallFunction<void(uint32_t), 48>;
+
+  explicit IoContext(Executor &executor);
+  ~IoContext() override;
+
+  IoContext(const IoContext &) = delete;
+  IoContext &operator=(const IoContext &) = delete;
+
+  // fd可读（EPOLLIN）时在Worker上执行f(events)
+  template <typename F>
+  void on_readable(int fd, F &&f);
+
+  // fd可写（EPOLLOUT）时在Worker上执行f(events)
+  template <typename F>
+  void on_writable(int fd, F &&f);
+
+  // 取消fd上的等待，回调还没有被调度时返回true
+  bool cancel(int fd);
+
+  IoAwaiter readable(int fd) { return IoAwaiter(*this, fd, EPOLLIN); }
+  IoAwaiter writable(int fd) { return IoAwaiter(*this, fd, EPOLLOUT); }
+
+  size_t num_pending();
+
+ private:
+  static constexpr size_t kMaxEvents = 64;
+
+  void Watch(int fd, uint32_t events, Callback callback);
+
+  bool Wait(const std::chrono::steady_clock::time_point *deadline) override;
+  void Wake() override;
+
+  bool TryAcquirePoller() { return !this->polling_.exchange(true, std::memory_order_acquire); }
+  void ReleasePoller() { this->polling_.store(false, std::memory_order_release); }
+  // 把Wait收集到的事件对应的回调交给Executor，只能由持有polling_的Worker调用，定义在executor.hpp
+  void Drain();
+
+  Executor &executor_;
+  int epoll_fd_{-1};
+  int event_fd_{-1};
+  std::atomic<bool> polling_{false};
+
+  std::mutex mutex_;
+  std::unordered_map<int, Callback> pending_;
+
+  // 只由持有polling_的Worker访问
+  std::array<epoll_event, kMaxEvents> events_{};
+  std::vector<std::pair<int, uint32_t>> ready_;
+  std::vector<std::pair<Callback, uint32_t>> fired_;
+};
+
+inline IoContext::IoContext(Executor &executor) : executor_(executor) {
+  this->epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  if (this->epoll_fd_ < 0) {
+    throw std::system_error(errno, std::system_category(), "epoll_create1");
+  }
+  this->event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (this->event_fd_ < 0) {
+    int err = errno;
+    close(this->epoll_fd_);
+    throw std::system_error(err, std::system_category(), "eventfd");
+  }
+  // event_fd_按水平触发注册，Wake在Wait之前调用时下一次epoll_wait立即返回
+  epoll_event ev{};
+  ev.events = EPOLLIN;
+  ev.data.fd = this->event_fd_;
+  if (epoll_ctl(this->epoll_fd_, EPOLL_CTL_ADD, this->event_fd_, &ev) != 0) {
+    int err = errno;
+    close(this->event_fd_);
+    close(this->epoll_fd_);
+    throw std::system_error(err, std::system_category(), "epoll_ctl");
+  }
+}
+
+inline IoContext::~IoContext() {
+  close(this->event_fd_);
+  close(this->epoll_fd_);
+}
+
+template <typename F>
+void IoContext::on_readable(int fd, F &&f) {
+  this->Watch(fd, EPOLLIN, Callback(std::forward<F>(f)));
+}
+
+template <typename F>
+void IoContext::on_writable(int fd, F &&f) {
+  this->Watch(fd, EPOLLOUT, Callback(std::forward<F>(f)));
+}
+
+// 在锁内修改epoll，Drain取回调时加同一个锁，回调总是在epoll_ctl返回之后执行
+inline void IoContext::Watch(int fd, uint32_t events, Callback callback) {
+  epoll_event ev{};
+  ev.events = events | EPOLLONESHOT;
+  ev.data.fd = fd;
+  std::lock_guard<std::mutex> lock(this->mutex_);
+  bool inserted = this->pending_.emplace(fd, std::move(callback)).second;
+  assert(inserted);  // 同一个fd同时只能有一个等待
+  (void)inserted;
+  // 触发过的EPOLLONESHOT仍然留在epoll中，只需要重新打开
+  if (epoll_ctl(this->epoll_fd_, EPOLL_CTL_MOD, fd, &ev) != 0 &&
+      (errno != ENOENT || epoll_ctl(this->epoll_fd_, EPOLL_CTL_ADD, fd, &ev) != 0)) {
+    int err = errno;
+    this->pending_.erase(fd);
+    throw std::system_error(err, std::system_category(), "epoll_ctl");
+  }
+}
+
+inline bool IoContext::cancel(int fd) {
+  std::lock_guard<std::mutex> lock(this->mutex_);
+  if (this->pending_.erase(fd) == 0) {
+    return false;
+  }
+  epoll_ctl(this->epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+  return true;
+}
+
+inline size_t IoContext::num_pending() {
+  std::lock_guard<std::mutex> lock(this->mutex_);
+  return this->pending_.size();
+}
+
+inline bool IoContext::Wait(const std::chrono::steady_clock::time_point *deadline) {
+  int timeout = -1;
+  if (deadline != nullptr) {
+    auto remaining = std::chrono::ceil<std::chrono::milliseconds>(*deadline - std::chrono::steady_clock::now());
+    timeout = static_cast<int>(std::max<int64_t>(remaining.count(), 0));
+  }
+  int n = epoll_wait(this->epoll_fd_, this->events_.data(), static_cast<int>(kMaxEvents), timeout);
+  bool has_io = false;
+  for (int i = 0; i < n; i++) {
+    // x86上epoll_event是packed结构，字段先复制出来
+    int fd = this->events_[i].data.fd;
+    uint32_t events = this->events_[i].events;
+    if (fd == this->event_fd_) {
+      uint64_t value = 0;
+      ssize_t r = read(this->event_fd_, &value, sizeof(value));
+      (void)r;
+    } else {
+      this->ready_.emplace_back(fd, events);
+      has_io = true;
+    }
+  }
+  return has_io;
+}
+
+inline void IoContext::Wake() {
+  uint64_t one = 1;
+  ssize_t r = write(this->event_fd_, &one, sizeof(one));
+  (void)r;
+}
+
+// 回调执行之前awaiter一直有效，回调中只在resume之前访问this
+template <typename H>
+void IoAwaiter::await_suspend(H h) {
+  this->io_.Watch(this->fd_, this->events_, [this, h](uint32_t events) mutable {
+    this->result_ = events;
+    h.resume();
+  });
+}
+
+}  // namespace shanzhai_tf
+
+#endif  // __linux__
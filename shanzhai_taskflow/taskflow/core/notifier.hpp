@@ -6,24 +6,81 @@
 
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <condition_variable>
 #include <cstddef>
+#include <cstdint>
 #include <mutex>
 #include <thread>
 #include <vector>
 
+#include "taskflow/core/cache_line.hpp"
+#ifdef SHANZHAI_TF_ENABLE_NOTIFIER_STATS
+#include "taskflow/core/histogram.hpp"
+#endif
+
+// Waiter挂起方式，编译期选择
+// SHANZHAI_TF_PARK_CV-默认，mutex + condition_variable
+// SHANZHAI_TF_PARK_ATOMIC-C++20 std::atomic<unsigned>::wait/notify_one
+// SHANZHAI_TF_PARK_FUTEX-Linux futex系统调用
+#define SHANZHAI_TF_PARK_CV 0
+#define SHANZHAI_TF_PARK_ATOMIC 1
+#define SHANZHAI_TF_PARK_FUTEX 2
+
+#ifndef SHANZHAI_TF_NOTIFIER_PARK
+#define SHANZHAI_TF_NOTIFIER_PARK SHANZHAI_TF_PARK_CV
+#endif
+
+#if SHANZHAI_TF_NOTIFIER_PARK == SHANZHAI_TF_PARK_ATOMIC
+#if !defined(__cpp_lib_atomic_wait)
+#error "SHANZHAI_TF_PARK_ATOMIC requires C++20 std::atomic::wait"
+#endif
+#elif SHANZHAI_TF_NOTIFIER_PARK == SHANZHAI_TF_PARK_FUTEX
+#if !defined(__linux__)
+#error "SHANZHAI_TF_PARK_FUTEX is only available on Linux"
+#endif
+#elif SHANZHAI_TF_NOTIFIER_PARK != SHANZHAI_TF_PARK_CV
+#error "unknown SHANZHAI_TF_NOTIFIER_PARK"
+#endif
+
+// std::atomic::wait不支持超时，ATOMIC方式下带超时的挂起在Linux上改用futex，其他平台改用condition_variable
+#if SHANZHAI_TF_NOTIFIER_PARK == SHANZHAI_TF_PARK_FUTEX || \
+    (SHANZHAI_TF_NOTIFIER_PARK == SHANZHAI_TF_PARK_ATOMIC && defined(__linux__))
+#define SHANZHAI_TF_NOTIFIER_USE_FUTEX 1
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <ctime>
+#else
+#define SHANZHAI_TF_NOTIFIER_USE_FUTEX 0
+#endif
+
+// Notify(true)是否使用树形唤醒，默认开启，定义为0时由Notify线程逐个唤醒
+#ifndef SHANZHAI_TF_NOTIFIER_TREE_WAKE
+#define SHANZHAI_TF_NOTIFIER_TREE_WAKE 1
+#endif
+
+// 定义SHANZHAI_TF_ENABLE_NOTIFIER_STATS后统计Notifier内部事件，未定义时计数代码不参与编译
+#ifdef SHANZHAI_TF_ENABLE_NOTIFIER_STATS
+#define SHANZHAI_TF_NOTIFIER_COUNT(counter) (counter).fetch_add(1, std::memory_order_relaxed)
+#else
+#define SHANZHAI_TF_NOTIFIER_COUNT(counter)
+#endif
+
 namespace shanzhai_tf {
 
 /*
-多线程同步，最多支持 65535 个 Waiter
-基本原理：
+多线程同步，默认布局（Notifier）最多支持 65533 个 Waiter，WideNotifier 最多支持 1048573 个 Waiter
+基本原理（以默认布局为例，各部分位宽由StateT在编译期决定）：
 （1）Notifier::state_分为3部分
    1.1 高32位，修改计数，CommitWait、CancelWait、Notify、NotifyN会修改
    1.2 低32位的高16位，标记PrepareWait数量
    1.3 低32位的低16位，记录等待中的Waiter，采用链表的形式
-（2）初始化时低16位全1，也就是没有任何Waiter
+（2）初始化时低16位全1，也就是没有任何Waiter；低16位为全1减1表示等待栈被冻结，见9.3
 （3）PrepareWait = 把Notifier::state_当前值保存在Waiter::epoch_，然后1.2节部分+1
 （4）CommitWait = 标记Waiter::state_为kNotSignaled，计算epoch=Waiter::state_高32位以及低32位的高16位左移16位之和epoch
    3.1 如果epoch大于1.1，说明前面还有处于PrepareWait的等待线程，那么让出cpu
@@ -34,18 +91,168 @@ namespace shanzhai_tf {
    6.1 如果等待列表和1.2为空，那么直接返回
    6.2 如果notify所有，那么清空1.2、1.3并修改1.1+1.2数量
    6.3 如果不是，那么优先唤醒一个PrepareWait线程，否则唤醒在等待列表的线程
+   6.4 NotifyN一次CAS同时减少1.2并冻结等待栈，之后数出需要弹出的Waiter，解冻时换上新的栈顶，再逐个唤醒
+   6.5 Notify、NotifyN返回被唤醒（含PrepareWait）的Waiter数量，为0说明调用时没有任何Waiter，
+       树形唤醒时等待栈只计1个，返回值是下界
+   6.6 Notify(true)一次CAS摘下整个等待栈，开启SHANZHAI_TF_NOTIFIER_TREE_WAKE时只唤醒栈顶，
+       被唤醒的Waiter把自己负责的剩余链表一分为二，分别交给两段的第一个Waiter后唤醒它们，
+       Notify线程的开销为O(1)，最后一个Waiter在O(log n)轮之后被唤醒
+（7）挂起/唤醒 = Park/Unpark，由SHANZHAI_TF_NOTIFIER_PARK决定
+   7.1 CV方式下Notify需要持有Waiter::mutex_修改Waiter::state_
+   7.2 ATOMIC/FUTEX方式下Unpark只需一次exchange，若对方已处于kWaiting再发起一次唤醒系统调用，无需加锁
+   7.3 ATOMIC方式下带超时挂起时state_为kTimedWaiting，Unpark看到后改用futex（Linux）或者cv唤醒
+（8）SpinT决定Park之前是否先自旋等待kSignaled：
+   8.1 自旋时pause次数指数增长，超过kMaxPauses后改为yield，超过时间预算后挂起
+   8.2 自旋成功时预算翻倍（不超过kBudgetNs），失败时减半（不低于kBudgetNs/16），
+       任务间隔短时多转，长期空闲时尽快挂起
+   8.3 PrepareWait线程还没有提交时（epoch落后）同样按照指数退避等待
+（9）NotifyWaiter唤醒指定的Waiter，不影响其他Waiter：
+   9.1 先置位Waiter::notified_，PrepareWait中的Waiter在CommitWait时发现后按CancelWait处理，
+       Waiter没有在等待时notified_保留到下一次等待，下一次CommitWait立即返回
+   9.2 Waiter入栈之前置位in_stack_，本次等待结束时清除；NotifyWaiter看到in_stack_为false时不访问等待栈，
+       与Waiter入栈后检查notified_构成Dekker式的配对，两者至少有一方看到对方
+   9.3 in_stack_为true时RemoveWaiter用一次CAS把栈顶改为kStackFrozen冻结等待栈，沿链表找到目标Waiter
+       并把它从链表中删除，再用一次CAS恢复栈顶；不占用PrepareWait名额，也不改变修改计数，
+       因此删除非栈顶的Waiter之后state_可能与冻结之前完全相同。为了不出现ABA，所有先读取栈中next_
+       再修改栈顶的操作（RemoveWaiter、Notify(false)与NotifyN的弹栈）都必须先冻结等待栈，
+       冻结期间next_不会变化；入栈与Notify(true)不依赖旧栈顶的next_，state_相同时CAS成功也是正确的
+   9.4 冻结期间需要访问等待栈的Notify/NotifyN/CommitWait/RemoveWaiter退避等待解冻，之后照常执行，
+       其他Waiter不会被额外唤醒，也不会有唤醒被吞掉；只唤醒PrepareWait线程的Notify不受影响
+（10）CommitWaitFor/CommitWaitUntil带超时挂起，超时返回false：
+   10.1 超时后通过RemoveWaiter把自己从等待栈中删除，与NotifyWaiter使用同样的方式归还名额
+   10.2 不在栈中说明已经被Notify弹出，此时继续等待对应的Unpark，返回true
+   10.3 ATOMIC方式下std::atomic::wait不支持超时，带超时的挂起见7.3，不会轮询
+   10.4 自旋阶段同样受deadline限制，自旋时间不超过剩余时间
+（11）定义SHANZHAI_TF_ENABLE_NOTIFIER_STATS后，Snapshot返回各类事件计数以及从Unpark到被唤醒线程返回的耗时分布，
+   Waiter侧的计数只由所属线程修改，Notify侧的CAS重试计数由Notifier统一记录；
+   num_stray_unparks统计Unpark了不在等待栈中的Waiter或者一次等待被Unpark多次，用于压力测试检查等待栈的正确性
+（12）SetExternalPark之后Waiter挂起时不使用cv/futex，而是调用ExternalPark::Wait（例如阻塞在epoll_wait上），
+   Unpark通过exchange修改state_后调用ExternalPark::Wake打断等待，与SHANZHAI_TF_NOTIFIER_PARK无关；
+   Wait报告有外部事件时按超时处理，Waiter从等待栈中删除自己后返回，已经被Notify弹出时继续等待Unpark
+（13）CheckStack在所有线程都已经挂起或者退出之后检查等待栈：没有停在kStackFrozen、
+   从栈顶出发每个Waiter至多出现一次（指向自己的next_也会被发现）并且都置位了in_stack_，栈中恰好有expected个Waiter
+*/
+
+/*
+Waiter挂起时代替cv/futex的外部等待，见io.hpp
+（1）Wait阻塞到Wake被调用、出现外部事件或者超过deadline为止，可以虚假返回，出现外部事件时返回true
+（2）Wake可能在Wait之前调用，此时之后的一次Wait必须立即返回
+*/
+class ExternalPark {
+ public:
+  virtual ~ExternalPark() = default;
+
+  virtual bool Wait(const std::chrono::steady_clock::time_point *deadline) = 0;
+  virtual void Wake() = 0;
+};
+
+/*
+state_各部分位宽，三部分共用一个64位原子变量，始终只需要64位CAS
+修改计数必须能区分所有PrepareWait中的Waiter，所以kEpochBits >= kStackBits + 2
 */
+struct NotifierState {
+  static constexpr uint64_t kStackBits = 16;
+  static constexpr uint64_t kWaiterBits = 16;
+};
+
+// 加宽等待栈和PrepareWait计数，修改计数缩短为24位，超过65533个Waiter时使用
+struct WideNotifierState {
+  static constexpr uint64_t kStackBits = 20;
+  static constexpr uint64_t kWaiterBits = 20;
+};
+
+// 不自旋，直接挂起
+struct NoSpinPolicy {
+  static constexpr bool kSpin = false;
+  static constexpr uint32_t kMaxPauses = 0;
+  static constexpr int64_t kBudgetNs = 0;
+};
+
+// 挂起前最多自旋BudgetNs纳秒，每轮pause次数从1开始翻倍直到MaxPauses
+template <int64_t BudgetNs = 50000, uint32_t MaxPauses = 64>
+struct SpinPolicy {
+  static constexpr bool kSpin = true;
+  static constexpr uint32_t kMaxPauses = MaxPauses;
+  static constexpr int64_t kBudgetNs = BudgetNs;
+};
+
+inline void CpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield" ::: "memory");
+#else
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
 
-class Notifier {
+// 指数退避，pause次数超过MaxPauses后改为yield
+template <uint32_t MaxPauses>
+class Backoff {
  public:
-  struct Waiter {
+  void Pause() {
+    if (this->pauses_ <= MaxPauses) {
+      for (uint32_t i = 0; i < this->pauses_; i++) {
+        CpuRelax();
+      }
+      this->pauses_ <<= 1;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+ private:
+  uint32_t pauses_{1};
+};
+
+template <typename StateT = NotifierState, typename SpinT = NoSpinPolicy>
+class BasicNotifier {
+ public:
+  // 每个Waiter独占缓存行，避免相邻Waiter之间伪共享
+  struct alignas(kCacheLineSize) Waiter {
     std::atomic<Waiter *> next_;
     uint64_t epoch_;
-    enum : unsigned { kNotSignaled = 0, kWaiting = 1, kSignaled = 2 };
-
+    std::atomic<bool> notified_{false};  // NotifyWaiter置位，本次等待结束时清除
+    std::atomic<bool> in_stack_{false};  // 入栈之前置位，本次等待结束时清除
+    // 树形唤醒时被唤醒后由自己负责唤醒的链表，Unpark之前写入
+    Waiter *wake_list_{nullptr};
+    size_t wake_count_{0};
+    // kTimedWaiting只出现在ATOMIC方式下带超时的挂起
+    enum : unsigned { kNotSignaled = 0, kWaiting = 1, kSignaled = 2, kTimedWaiting = 3 };
+
+#if SHANZHAI_TF_NOTIFIER_PARK == SHANZHAI_TF_PARK_CV || \
+    (SHANZHAI_TF_NOTIFIER_PARK == SHANZHAI_TF_PARK_ATOMIC && !SHANZHAI_TF_NOTIFIER_USE_FUTEX)
     std::mutex mutex_;
     std::condition_variable cv_;
-    unsigned state_;
+#endif
+    // CV方式下在mutex_内修改，自旋时在锁外读取
+    std::atomic<unsigned> state_;
+    // 由所属线程在CommitWait之前设置，入栈的CAS保证Unpark能看到
+    std::atomic<ExternalPark *> external_{nullptr};
+
+    // 只由所属线程修改
+    int64_t spin_budget_ns_{SpinT::kBudgetNs};
+    std::atomic<uint64_t> num_spin_wakeups_{0};
+    std::atomic<uint64_t> num_park_wakeups_{0};
+
+#ifdef SHANZHAI_TF_ENABLE_NOTIFIER_STATS
+    std::atomic<uint64_t> num_prepare_waits_{0};
+    std::atomic<uint64_t> num_cancel_waits_{0};
+    std::atomic<uint64_t> num_commit_parks_{0};
+    std::atomic<uint64_t> num_commit_timeouts_{0};
+    std::atomic<uint64_t> num_spurious_wakeups_{0};
+    std::atomic<uint64_t> num_commit_cas_retries_{0};
+    std::atomic<uint64_t> num_epoch_yields_{0};
+    std::atomic<int64_t> notify_ns_{0};  // Unpark时写入
+    std::atomic<uint64_t> num_unparks_{0};  // 本次等待收到的Unpark次数，被唤醒之后清零
+    Histogram wake_latency_ns_{};
+#endif
+  };
+
+  // 被唤醒时的统计，只有SpinT::kSpin为true时才会计数
+  struct SpinStats {
+    uint64_t num_spin_wakeups{0};
+    uint64_t num_park_wakeups{0};
   };
 
  private:
@@ -53,67 +260,184 @@ class Notifier {
   // [0, kStackBits)-等待栈.
   // [kStackBits, kStackBits + kWaiterBits)-PrepareWait总数.
   // [kStackBits + kWaiterBits, 64)-修改计数.
-  static const uint64_t kStackBits = 16;
-  static const uint64_t kStackMask = (1ull << kStackBits) - 1;  // 低32位的低16全1，高16全0
-  static const uint64_t kWaiterBits = 16;
-  static const uint64_t kWaiterShift = 16;
-  static const uint64_t kWaiterMask = ((1ull << kWaiterBits) - 1) << kWaiterShift;  // 低32位的高16位全1，低16全0
-  static const uint64_t kEpochBits = 32;
-  static const uint64_t kEpochShift = 32;
-  static const uint64_t kEpochMask = ((1ull << kEpochBits) - 1) << kEpochShift;  // 高32位全1，低32全0
-
-  static const uint64_t kWaiterInc = 1ull << kWaiterBits;
-  static const uint64_t kEpochInc = 1ull << kEpochShift;
+  static constexpr uint64_t kStackBits = StateT::kStackBits;
+  static constexpr uint64_t kStackMask = (1ull << kStackBits) - 1;  // 默认布局：低32位的低16全1，高16全0
+  static constexpr uint64_t kStackFrozen = kStackMask - 1;          // 冻结等待栈期间的栈顶，见9.3
+  static constexpr uint64_t kWaiterBits = StateT::kWaiterBits;
+  static constexpr uint64_t kWaiterShift = kStackBits;
+  static constexpr uint64_t kWaiterMask = ((1ull << kWaiterBits) - 1) << kWaiterShift;  // 默认布局：低32位的高16位全1，低16全0
+  static constexpr uint64_t kEpochShift = kStackBits + kWaiterBits;
+  static constexpr uint64_t kEpochBits = 64 - kEpochShift;
+  static constexpr uint64_t kEpochMask = ((1ull << kEpochBits) - 1) << kEpochShift;  // 默认布局：高32位全1，低32全0
+
+  static constexpr uint64_t kWaiterInc = 1ull << kWaiterShift;
+  static constexpr uint64_t kEpochInc = 1ull << kEpochShift;
+
+  static_assert(kWaiterBits >= kStackBits, "PrepareWait count must hold every Waiter");
+  static_assert(kEpochShift < 64 && kEpochBits >= kStackBits + 2, "epoch must outrun every pending Waiter");
 
  public:
-  explicit Notifier(size_t N);
-  ~Notifier();
+  explicit BasicNotifier(size_t N);
+  ~BasicNotifier();
+
+  using Clock = std::chrono::steady_clock;
 
   void PrepareWait(Waiter *w);
   void CommitWait(Waiter *w);
+
+  // 被通知返回true，超时返回false，两者都会结束本次等待
+  template <typename Rep, typename Period>
+  bool CommitWaitFor(Waiter *w, const std::chrono::duration<Rep, Period> &timeout);
+  template <typename C, typename Duration>
+  bool CommitWaitUntil(Waiter *w, const std::chrono::time_point<C, Duration> &deadline);
+  bool CommitWaitUntil(Waiter *w, const Clock::time_point &deadline);
   void CancelWait(Waiter *w);
-  void Notify(bool all);
-  void NotifyN(size_t n);
+  size_t Notify(bool all);
+  size_t NotifyN(size_t n);
+
+  // 只唤醒w，w在等待栈中时返回true，w处于PrepareWait时它的CommitWait会立即返回
+  bool NotifyWaiter(Waiter *w);
+  bool NotifyIndex(size_t idx);
+  // w在等待栈中（已经挂起或者正要挂起），只是一个提示，返回之后随时可能变化
+  bool IsParked(const Waiter *w) const { return w->in_stack_.load(std::memory_order_acquire); }
 
   Waiter *GetWaiter(size_t idx);
 
+  // 只能由w所属的线程在PrepareWait之前或者等待结束之后调用，external为nullptr时恢复默认方式
+  void SetExternalPark(Waiter *w, ExternalPark *external) { w->external_.store(external, std::memory_order_relaxed); }
+
+  SpinStats GetSpinStats() const;
+
+  // 未定义SHANZHAI_TF_ENABLE_NOTIFIER_STATS时全部为0
+  struct Stats {
+    uint64_t num_prepare_waits{0};
+    uint64_t num_cancel_waits{0};
+    uint64_t num_commit_parks{0};
+    uint64_t num_commit_timeouts{0};
+    uint64_t num_spurious_wakeups{0};
+    uint64_t num_notify_cas_retries{0};
+    uint64_t num_stray_unparks{0};  // Unpark了不在等待栈中的Waiter或者同一次等待被Unpark多次，正确时总是0
+    uint64_t num_commit_cas_retries{0};
+    uint64_t num_epoch_yields{0};
+#ifdef SHANZHAI_TF_ENABLE_NOTIFIER_STATS
+    HistogramData wake_latency_ns{};
+#endif
+  };
+
+  Stats Snapshot() const;
+
+  // 用于测试，只能在没有并发的Wait/Notify时调用，见(13)
+  bool CheckStack(size_t expected) const;
+
  private:
-  std::vector<Waiter> waiters_{};
-  std::atomic<uint64_t> state_{0};
+#ifdef SHANZHAI_TF_ENABLE_NOTIFIER_STATS
+  static int64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+#endif
+
+  // deadline为nullptr时不超时
+  bool Wait(Waiter *w, const Clock::time_point *deadline);
+  bool Spin(Waiter *w, const Clock::time_point *deadline);
+  // until_signaled为true时外部事件不会使Park返回，用于超时后RemoveWaiter失败、确定会被Unpark的情况
+  bool Park(Waiter *w, const Clock::time_point *deadline, bool until_signaled = false);
+  bool ParkExternal(Waiter *w, ExternalPark *external, const Clock::time_point *deadline, bool until_signaled);
+  void Unpark(Waiter *w);
+  size_t UnparkList(Waiter *w, size_t n);
+  size_t UnparkAll(Waiter *w);
+  void PropagateWake(Waiter *w);
+  bool RemoveWaiter(Waiter *w);
+  // 由冻结等待栈的一方调用，把栈顶换成top（nullptr表示空栈）
+  void Unfreeze(Waiter *top);
+#if SHANZHAI_TF_NOTIFIER_USE_FUTEX
+  // remaining为nullptr时不超时
+  static void FutexWait(Waiter *w, unsigned expected, const Clock::duration *remaining);
+  static void FutexWake(Waiter *w);
+#endif
+
+  std::vector<Waiter, AlignedAllocator<Waiter>> waiters_{};
+  alignas(kCacheLineSize) std::atomic<uint64_t> state_{0};
+#ifdef SHANZHAI_TF_ENABLE_NOTIFIER_STATS
+  alignas(kCacheLineSize) std::atomic<uint64_t> num_notify_cas_retries_{0};
+  std::atomic<uint64_t> num_stray_unparks_{0};
+#endif
 };
 
-Notifier::Notifier(size_t N) : waiters_(N) {
-  assert(this->waiters_.size() < ((1 << kWaiterBits)) - 1);  // 限制最大的Waiter数量
+template <typename StateT, typename SpinT>
+BasicNotifier<StateT, SpinT>::BasicNotifier(size_t N) : waiters_(N) {
+  assert(this->waiters_.size() < kStackFrozen);  // 限制最大的Waiter数量，kStackMask表示空栈，kStackFrozen表示冻结
   // kEpochMask = 4294967295 * kEpochInc;
   this->state_ = kStackMask | (kEpochMask - kEpochInc * this->waiters_.size() * 2);
 }
 
-Notifier::~Notifier() {
+template <typename StateT, typename SpinT>
+BasicNotifier<StateT, SpinT>::~BasicNotifier() {
   assert((this->state_.load() & (kStackMask | kWaiterMask)) == kStackMask);  // 最后没有任何Waiter
 }
 
-void Notifier::PrepareWait(Waiter *w) {
+template <typename StateT, typename SpinT>
+void BasicNotifier<StateT, SpinT>::PrepareWait(Waiter *w) {
+  SHANZHAI_TF_NOTIFIER_COUNT(w->num_prepare_waits_);
   w->epoch_ = this->state_.fetch_add(kWaiterInc, std::memory_order_relaxed);
   std::atomic_thread_fence(std::memory_order_seq_cst);
 }
 
-void Notifier::CommitWait(Waiter *w) {
-  w->state_ = Waiter::kNotSignaled;
+template <typename StateT, typename SpinT>
+void BasicNotifier<StateT, SpinT>::CommitWait(Waiter *w) {
+  this->Wait(w, nullptr);
+}
+
+template <typename StateT, typename SpinT>
+template <typename Rep, typename Period>
+bool BasicNotifier<StateT, SpinT>::CommitWaitFor(Waiter *w, const std::chrono::duration<Rep, Period> &timeout) {
+  return this->CommitWaitUntil(w, Clock::now() + std::chrono::ceil<Clock::duration>(timeout));
+}
+
+template <typename StateT, typename SpinT>
+template <typename C, typename Duration>
+bool BasicNotifier<StateT, SpinT>::CommitWaitUntil(Waiter *w, const std::chrono::time_point<C, Duration> &deadline) {
+  return this->CommitWaitUntil(w, Clock::now() + std::chrono::ceil<Clock::duration>(deadline - C::now()));
+}
+
+template <typename StateT, typename SpinT>
+bool BasicNotifier<StateT, SpinT>::CommitWaitUntil(Waiter *w, const Clock::time_point &deadline) {
+  return this->Wait(w, &deadline);
+}
+
+template <typename StateT, typename SpinT>
+bool BasicNotifier<StateT, SpinT>::Wait(Waiter *w, const Clock::time_point *deadline) {
+  if (w->notified_.exchange(false, std::memory_order_acq_rel)) {
+    this->CancelWait(w);
+    return true;
+  }
+  w->state_.store(Waiter::kNotSignaled, std::memory_order_relaxed);
   uint64_t epoch = (w->epoch_ & kEpochMask) + (((w->epoch_ & kWaiterMask) >> kWaiterShift) << kEpochShift);
+  // 与NotifyWaiter配对：NotifyWaiter先写notified_再读in_stack_，这里先写in_stack_，入栈后再读notified_
+  w->in_stack_.store(true, std::memory_order_seq_cst);
   uint64_t state = this->state_.load(std::memory_order_seq_cst);
+  Backoff<SpinT::kMaxPauses> backoff;
   for (;;) {
     if (static_cast<int64_t>((state & kEpochMask) - epoch) < 0) {
-      std::this_thread::yield();
+      SHANZHAI_TF_NOTIFIER_COUNT(w->num_epoch_yields_);
+      backoff.Pause();
       state = this->state_.load(std::memory_order_seq_cst);
       continue;
     }
 
     if (static_cast<int64_t>((state & kEpochMask) - epoch) > 0) {
-      return;
+      w->in_stack_.store(false, std::memory_order_relaxed);
+      return true;
     }
 
     assert((state & kWaiterMask) != 0);
 
+    if ((state & kStackMask) == kStackFrozen) {
+      backoff.Pause();
+      state = this->state_.load(std::memory_order_seq_cst);
+      continue;
+    }
+
     uint64_t new_state = state - kWaiterInc + kEpochInc;
 
     new_state = static_cast<uint64_t>(new_state & (~kStackMask)) | static_cast<uint64_t>(w - &this->waiters_[0]);
@@ -123,27 +447,57 @@ void Notifier::CommitWait(Waiter *w) {
       w->next_.store(&this->waiters_[state & kStackMask], std::memory_order_relaxed);
     }
 
-    if (this->state_.compare_exchange_weak(state, new_state, std::memory_order_release)) {
+    // acquire保证入栈前被NotifyWaiter摘下等待栈时能看到notified_
+    if (this->state_.compare_exchange_weak(state, new_state, std::memory_order_acq_rel)) {
       break;
     }
+    SHANZHAI_TF_NOTIFIER_COUNT(w->num_commit_cas_retries_);
   }
 
-  // park
-  {
-    std::unique_lock<std::mutex> lock(w->mutex_);
-    while (w->state_ != Waiter::kSignaled) {
-      w->state_ = Waiter::kWaiting;
-      w->cv_.wait(lock);
+  if (w->notified_.load(std::memory_order_seq_cst) && this->RemoveWaiter(w)) {
+    w->in_stack_.store(false, std::memory_order_relaxed);
+    w->notified_.store(false, std::memory_order_relaxed);
+    return true;
+  }
+
+  SHANZHAI_TF_NOTIFIER_COUNT(w->num_commit_parks_);
+  if (!this->Park(w, deadline)) {
+    if (this->RemoveWaiter(w)) {
+      SHANZHAI_TF_NOTIFIER_COUNT(w->num_commit_timeouts_);
+      w->in_stack_.store(false, std::memory_order_relaxed);
+      // 超时的同时NotifyWaiter置位了notified_，视为被通知
+      return w->notified_.exchange(false, std::memory_order_acq_rel);
     }
+    this->Park(w, nullptr, true);
   }
+#ifdef SHANZHAI_TF_ENABLE_NOTIFIER_STATS
+  // 在PropagateWake之前取时间，唤醒延迟不包含代为唤醒子节点的时间
+  int64_t latency = NowNs() - w->notify_ns_.load(std::memory_order_relaxed);
+#endif
+  // 被Notify弹出或者被RemoveWaiter删除之后才会被唤醒，此时已经不在栈中
+  w->in_stack_.store(false, std::memory_order_relaxed);
+#ifdef SHANZHAI_TF_ENABLE_NOTIFIER_STATS
+  w->num_unparks_.store(0, std::memory_order_release);
+#endif
+  this->PropagateWake(w);
+  w->notified_.store(false, std::memory_order_relaxed);
+#ifdef SHANZHAI_TF_ENABLE_NOTIFIER_STATS
+  w->wake_latency_ns_.Record(latency > 0 ? static_cast<uint64_t>(latency) : 0);
+#endif
+  return true;
 }
 
-void Notifier::CancelWait(Waiter *w) {
+template <typename StateT, typename SpinT>
+void BasicNotifier<StateT, SpinT>::CancelWait(Waiter *w) {
+  SHANZHAI_TF_NOTIFIER_COUNT(w->num_cancel_waits_);
+  w->notified_.store(false, std::memory_order_relaxed);
   uint64_t epoch = (w->epoch_ & kEpochMask) + (((w->epoch_ & kWaiterMask) >> kWaiterShift) << kEpochShift);
   uint64_t state = this->state_.load(std::memory_order_relaxed);
+  Backoff<SpinT::kMaxPauses> backoff;
   for (;;) {
     if (static_cast<int64_t>((state & kEpochMask) - epoch) < 0) {
-      std::this_thread::yield();
+      SHANZHAI_TF_NOTIFIER_COUNT(w->num_epoch_yields_);
+      backoff.Pause();
       state = this->state_.load(std::memory_order_seq_cst);
       continue;
     }
@@ -162,73 +516,491 @@ void Notifier::CancelWait(Waiter *w) {
   }
 }
 
-void Notifier::Notify(bool all) {
+template <typename StateT, typename SpinT>
+size_t BasicNotifier<StateT, SpinT>::Notify(bool all) {
   std::atomic_thread_fence(std::memory_order_seq_cst);
   uint64_t state = this->state_.load(std::memory_order_acquire);
+  Backoff<SpinT::kMaxPauses> backoff;
   for (;;) {
     if ((state & kStackMask) == kStackMask && (state & kWaiterMask) == 0) {
-      return;
+      return 0;
     }
     uint64_t waiters = (state & kWaiterMask) >> kWaiterShift;
+    // 等待栈被冻结时只能唤醒PrepareWait线程，需要弹栈时等待RemoveWaiter解冻
+    if ((state & kStackMask) == kStackFrozen && (all || waiters == 0)) {
+      backoff.Pause();
+      state = this->state_.load(std::memory_order_acquire);
+      continue;
+    }
     uint64_t new_state = 0;
     if (all) {
       new_state = (state & kEpochMask) + (kEpochInc * waiters) + kStackMask;
     } else if (waiters > 0) {
       new_state = state + kEpochInc - kWaiterInc;
     } else {
-      auto w = &this->waiters_[state & kStackMask];
-      auto w_next = w->next_.load(std::memory_order_relaxed);
-      uint64_t next = kStackMask;
-      if (w_next != nullptr) {
-        next = static_cast<uint64_t>(w_next - &this->waiters_[0]);
-      }
-      new_state = (state & kEpochMask) + next;
+      // 弹栈需要读取栈顶的next_，先冻结等待栈，解冻时再换上新的栈顶，见9.3
+      new_state = (state & ~kStackMask) | kStackFrozen;
     }
     if (this->state_.compare_exchange_weak(state, new_state, std::memory_order_acquire)) {
       if (!all && waiters > 0) {
-        return;
+        return 1;
       }
       if ((state & kStackMask) == kStackMask) {
-        return;
+        return waiters;
       }
       auto w = &this->waiters_[state & kStackMask];
-      if (!all) {
-        w->next_.store(nullptr, std::memory_order_relaxed);
-      }
-
-      Waiter *loop_next = nullptr;
-      for (auto iter = w; iter != nullptr; iter = loop_next) {
-        loop_next = w->next_.load(std::memory_order_relaxed);
-        unsigned loop_state = 0;
-        {
-          std::unique_lock<std::mutex> loop_lock(iter->mutex_);
-          loop_state = iter->state_;
-          iter->state_ = Waiter::kSignaled;
-        }
-        if (loop_state == Waiter::kWaiting) {
-          iter->cv_.notify_one();
-        }
+      if (all) {
+        return waiters + this->UnparkAll(w);
       }
-      return;
+      this->Unfreeze(w->next_.load(std::memory_order_relaxed));
+      w->next_.store(nullptr, std::memory_order_relaxed);
+      return this->UnparkList(w, 1);
     }
+    SHANZHAI_TF_NOTIFIER_COUNT(this->num_notify_cas_retries_);
   }
 }
 
-void Notifier::NotifyN(size_t n) {
+template <typename StateT, typename SpinT>
+size_t BasicNotifier<StateT, SpinT>::NotifyN(size_t n) {
   if (n >= this->waiters_.size()) {
     return this->Notify(true);
-  } else {
-    for (size_t i = 0; i < n; i++) {
-      this->Notify(false);
+  }
+  if (n == 0) {
+    return 0;
+  }
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  uint64_t state = this->state_.load(std::memory_order_acquire);
+  Backoff<SpinT::kMaxPauses> backoff;
+  for (;;) {
+    if ((state & kStackMask) == kStackMask && (state & kWaiterMask) == 0) {
+      return 0;
+    }
+    // 先唤醒min(n, PrepareWait数量)个PrepareWait线程，剩余的从等待栈弹出
+    uint64_t waiters = (state & kWaiterMask) >> kWaiterShift;
+    if ((state & kStackMask) == kStackFrozen && n > waiters) {
+      backoff.Pause();
+      state = this->state_.load(std::memory_order_acquire);
+      continue;
+    }
+    uint64_t num_prewaiters = n < waiters ? n : waiters;
+    // 需要弹栈时同一次CAS冻结等待栈，冻结之后再沿next_数出弹出的Waiter
+    const bool pop = num_prewaiters < n && (state & kStackMask) != kStackMask;
+    uint64_t new_state = (state & kEpochMask) + kEpochInc * num_prewaiters +
+                         (((waiters - num_prewaiters) << kWaiterShift) & kWaiterMask) +
+                         (pop ? kStackFrozen : (state & kStackMask));
+    if (this->state_.compare_exchange_weak(state, new_state, std::memory_order_acquire)) {
+      if (!pop) {
+        return num_prewaiters;
+      }
+      Waiter *top = &this->waiters_[state & kStackMask];
+      Waiter *next = top;
+      uint64_t num_pop = 0;
+      for (; num_pop < n - num_prewaiters && next != nullptr; num_pop++) {
+        next = next->next_.load(std::memory_order_relaxed);
+      }
+      this->Unfreeze(next);
+      this->UnparkList(top, num_pop);
+      return num_prewaiters + num_pop;
     }
+    SHANZHAI_TF_NOTIFIER_COUNT(this->num_notify_cas_retries_);
   }
 }
 
-Notifier::Waiter *Notifier::GetWaiter(size_t idx) {
+template <typename StateT, typename SpinT>
+bool BasicNotifier<StateT, SpinT>::NotifyWaiter(Waiter *w) {
+  w->notified_.store(true, std::memory_order_seq_cst);
+  // 常见情况下w没有挂起（例如还在CorunUntil中执行任务），只留下notified_，不访问等待栈
+  if (!w->in_stack_.load(std::memory_order_seq_cst)) {
+    return false;
+  }
+  if (this->RemoveWaiter(w)) {
+    this->Unpark(w);
+    return true;
+  }
+  return false;
+}
+
+template <typename StateT, typename SpinT>
+bool BasicNotifier<StateT, SpinT>::NotifyIndex(size_t idx) {
+  assert(idx < this->waiters_.size());
+  return this->NotifyWaiter(&this->waiters_[idx]);
+}
+
+// 冻结等待栈后从链表中删除w，w不在栈中时返回false；只遍历到w为止
+template <typename StateT, typename SpinT>
+bool BasicNotifier<StateT, SpinT>::RemoveWaiter(Waiter *w) {
+  uint64_t state = this->state_.load(std::memory_order_relaxed);
+  Backoff<SpinT::kMaxPauses> backoff;
+  for (;;) {
+    const uint64_t top = state & kStackMask;
+    if (top == kStackMask) {
+      return false;
+    }
+    if (top == kStackFrozen) {
+      backoff.Pause();
+      state = this->state_.load(std::memory_order_relaxed);
+      continue;
+    }
+    if (this->state_.compare_exchange_weak(state, (state & ~kStackMask) | kStackFrozen, std::memory_order_acquire,
+                                           std::memory_order_relaxed)) {
+      break;
+    }
+  }
+
+  // 冻结期间没有线程入栈或者出栈，栈中的Waiter不会修改next_
+  Waiter *top = &this->waiters_[state & kStackMask];
+  Waiter *prev = nullptr;
+  Waiter *iter = top;
+  while (iter != nullptr && iter != w) {
+    prev = iter;
+    iter = iter->next_.load(std::memory_order_relaxed);
+  }
+  const bool found = iter != nullptr;
+  if (found) {
+    Waiter *next = w->next_.load(std::memory_order_relaxed);
+    if (prev == nullptr) {
+      top = next;
+    } else {
+      prev->next_.store(next, std::memory_order_relaxed);
+    }
+  }
+
+  this->Unfreeze(top);
+  return found;
+}
+
+// 冻结期间修改计数与PrepareWait数量仍可能变化，只替换栈顶
+template <typename StateT, typename SpinT>
+void BasicNotifier<StateT, SpinT>::Unfreeze(Waiter *top) {
+  const uint64_t top_bits = top == nullptr ? kStackMask : static_cast<uint64_t>(top - &this->waiters_[0]);
+  uint64_t state = this->state_.load(std::memory_order_relaxed);
+  while (!this->state_.compare_exchange_weak(state, (state & ~kStackMask) | top_bits, std::memory_order_release,
+                                             std::memory_order_relaxed)) {
+  }
+}
+
+template <typename StateT, typename SpinT>
+bool BasicNotifier<StateT, SpinT>::Spin(Waiter *w, const Clock::time_point *deadline) {
+  auto until = std::chrono::steady_clock::now() + std::chrono::nanoseconds(w->spin_budget_ns_);
+  // 不超过调用者的deadline，因此停止时预算不减半
+  const bool capped = deadline != nullptr && *deadline < until;
+  if (capped) {
+    until = *deadline;
+  }
+  Backoff<SpinT::kMaxPauses> backoff;
+  for (;;) {
+    if (w->state_.load(std::memory_order_acquire) == Waiter::kSignaled) {
+      w->spin_budget_ns_ = std::min(w->spin_budget_ns_ * 2, SpinT::kBudgetNs);
+      return true;
+    }
+    backoff.Pause();
+    if (std::chrono::steady_clock::now() >= until) {
+      if (!capped) {
+        w->spin_budget_ns_ = std::max(w->spin_budget_ns_ / 2, SpinT::kBudgetNs / 16);
+      }
+      return false;
+    }
+  }
+}
+
+template <typename StateT, typename SpinT>
+bool BasicNotifier<StateT, SpinT>::Park(Waiter *w, const Clock::time_point *deadline, bool until_signaled) {
+  // until_signaled为true时这次等待已经计过数，信号已经在路上，直接挂起，不再自旋也不影响自旋预算
+  if constexpr (SpinT::kSpin) {
+    if (!until_signaled) {
+      if (this->Spin(w, deadline)) {
+        w->num_spin_wakeups_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+      }
+      w->num_park_wakeups_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  if (ExternalPark *external = w->external_.load(std::memory_order_relaxed); external != nullptr) {
+    return this->ParkExternal(w, external, deadline, until_signaled);
+  }
+#if SHANZHAI_TF_NOTIFIER_PARK == SHANZHAI_TF_PARK_CV
+  std::unique_lock<std::mutex> lock(w->mutex_);
+  while (w->state_.load(std::memory_order_relaxed) != Waiter::kSignaled) {
+    w->state_.store(Waiter::kWaiting, std::memory_order_relaxed);
+    if (deadline == nullptr) {
+      w->cv_.wait(lock);
+    } else if (w->cv_.wait_until(lock, *deadline) == std::cv_status::timeout) {
+      return w->state_.load(std::memory_order_relaxed) == Waiter::kSignaled;
+    }
+    if (w->state_.load(std::memory_order_relaxed) != Waiter::kSignaled) {
+      SHANZHAI_TF_NOTIFIER_COUNT(w->num_spurious_wakeups_);
+    }
+  }
+  return true;
+#else
+  unsigned waiting = Waiter::kWaiting;
+#if SHANZHAI_TF_NOTIFIER_PARK == SHANZHAI_TF_PARK_ATOMIC
+  if (deadline != nullptr) {
+    waiting = Waiter::kTimedWaiting;
+  }
+#endif
+  // Unpark可能已经先一步把state_改为kSignaled，此时无需挂起；
+  // 超时后再次挂起时state_仍是上一次的等待状态，ATOMIC方式下需要从kTimedWaiting改回kWaiting
+  unsigned state = w->state_.load(std::memory_order_acquire);
+  while (state != waiting) {
+    if (state == Waiter::kSignaled) {
+      return true;
+    }
+    if (w->state_.compare_exchange_weak(state, waiting, std::memory_order_acq_rel, std::memory_order_acquire)) {
+      break;
+    }
+  }
+  // 虚假唤醒时state_仍为waiting，继续等待
+  while (w->state_.load(std::memory_order_acquire) == waiting) {
+    Clock::duration remaining{};
+    if (deadline != nullptr) {
+      remaining = *deadline - Clock::now();
+      if (remaining <= Clock::duration::zero()) {
+        return false;
+      }
+    }
+#if SHANZHAI_TF_NOTIFIER_PARK == SHANZHAI_TF_PARK_ATOMIC
+    if (deadline == nullptr) {
+      w->state_.wait(Waiter::kWaiting, std::memory_order_acquire);
+    } else {
+#if SHANZHAI_TF_NOTIFIER_USE_FUTEX
+      FutexWait(w, Waiter::kTimedWaiting, &remaining);
+#else
+      std::unique_lock<std::mutex> lock(w->mutex_);
+      w->cv_.wait_until(lock, *deadline, [w]() {
+        return w->state_.load(std::memory_order_acquire) != Waiter::kTimedWaiting;
+      });
+#endif
+    }
+#else
+    FutexWait(w, Waiter::kWaiting, deadline == nullptr ? nullptr : &remaining);
+#endif
+    if (w->state_.load(std::memory_order_acquire) == waiting && deadline == nullptr) {
+      SHANZHAI_TF_NOTIFIER_COUNT(w->num_spurious_wakeups_);
+    }
+  }
+  return true;
+#endif
+}
+
+#if SHANZHAI_TF_NOTIFIER_USE_FUTEX
+template <typename StateT, typename SpinT>
+void BasicNotifier<StateT, SpinT>::FutexWait(Waiter *w, unsigned expected, const Clock::duration *remaining) {
+  static_assert(sizeof(std::atomic<unsigned>) == sizeof(unsigned), "futex requires a plain 32-bit word");
+  struct timespec ts {};
+  if (remaining != nullptr) {
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(*remaining).count();
+    ts.tv_sec = static_cast<time_t>(ns / 1000000000);
+    ts.tv_nsec = static_cast<long>(ns % 1000000000);  // NOLINT
+  }
+  syscall(SYS_futex, reinterpret_cast<unsigned *>(&w->state_), FUTEX_WAIT_PRIVATE, expected,
+          remaining == nullptr ? nullptr : &ts, nullptr, 0);
+}
+
+template <typename StateT, typename SpinT>
+void BasicNotifier<StateT, SpinT>::FutexWake(Waiter *w) {
+  syscall(SYS_futex, reinterpret_cast<unsigned *>(&w->state_), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+}
+#endif
+
+// 与ATOMIC/FUTEX方式相同的state_协议，挂起换成ExternalPark::Wait
+template <typename StateT, typename SpinT>
+bool BasicNotifier<StateT, SpinT>::ParkExternal(Waiter *w, ExternalPark *external, const Clock::time_point *deadline,
+                                                bool until_signaled) {
+  unsigned state = Waiter::kNotSignaled;
+  if (!w->state_.compare_exchange_strong(state, Waiter::kWaiting, std::memory_order_acq_rel) &&
+      state == Waiter::kSignaled) {
+    return true;
+  }
+  while (w->state_.load(std::memory_order_acquire) == Waiter::kWaiting) {
+    if (deadline != nullptr && Clock::now() >= *deadline) {
+      return false;
+    }
+    if (external->Wait(deadline) && !until_signaled) {
+      return w->state_.load(std::memory_order_acquire) == Waiter::kSignaled;
+    }
+  }
+  return true;
+}
+
+template <typename StateT, typename SpinT>
+size_t BasicNotifier<StateT, SpinT>::UnparkList(Waiter *w, size_t n) {
+  // 先读取next_再唤醒，被唤醒的Waiter可能立即重新入栈修改next_
+  size_t i = 0;
+  for (; i < n && w != nullptr; i++) {
+    Waiter *next = w->next_.load(std::memory_order_relaxed);
+    this->Unpark(w);
+    w = next;
+  }
+  return i;
+}
+
+// 唤醒从w开始的整个链表，树形唤醒时只唤醒w并返回1
+template <typename StateT, typename SpinT>
+size_t BasicNotifier<StateT, SpinT>::UnparkAll(Waiter *w) {
+#if SHANZHAI_TF_NOTIFIER_TREE_WAKE
+  if (w == nullptr) {
+    return 0;
+  }
+  w->wake_list_ = w->next_.load(std::memory_order_relaxed);
+  w->wake_count_ = SIZE_MAX;  // 长度未知，一直到链表结尾
+  this->Unpark(w);
+  return 1;
+#else
+  return this->UnparkList(w, this->waiters_.size());
+#endif
+}
+
+template <typename StateT, typename SpinT>
+void BasicNotifier<StateT, SpinT>::PropagateWake(Waiter *w) {
+  Waiter *list = w->wake_list_;
+  size_t n = w->wake_count_;
+  w->wake_list_ = nullptr;
+  w->wake_count_ = 0;
+  if (list == nullptr || n == 0) {
+    return;
+  }
+  // 链表中的Waiter都还没有被唤醒，next_不会变化
+  if (n == SIZE_MAX) {
+    n = 0;
+    for (Waiter *iter = list; iter != nullptr; iter = iter->next_.load(std::memory_order_relaxed)) {
+      n++;
+    }
+  }
+  // first负责[1, half)，second负责(half, n)
+  size_t half = (n + 1) / 2;
+  Waiter *first = list;
+  Waiter *second = nullptr;
+  if (half < n) {
+    second = first;
+    for (size_t i = 0; i < half; i++) {
+      second = second->next_.load(std::memory_order_relaxed);
+    }
+  }
+  first->wake_list_ = half > 1 ? first->next_.load(std::memory_order_relaxed) : nullptr;
+  first->wake_count_ = half - 1;
+  if (second != nullptr) {
+    second->wake_list_ = n - half > 1 ? second->next_.load(std::memory_order_relaxed) : nullptr;
+    second->wake_count_ = n - half - 1;
+  }
+  // 唤醒之后first可能立即重新入栈，second必须提前取出
+  this->Unpark(first);
+  if (second != nullptr) {
+    this->Unpark(second);
+  }
+}
+
+template <typename StateT, typename SpinT>
+void BasicNotifier<StateT, SpinT>::Unpark(Waiter *w) {
+#ifdef SHANZHAI_TF_ENABLE_NOTIFIER_STATS
+  w->notify_ns_.store(NowNs(), std::memory_order_relaxed);
+  // 先计数再读in_stack_，与被唤醒的一方先清除in_stack_再清零计数配对，重复的Unpark总有一项检查能发现
+  if (w->num_unparks_.fetch_add(1, std::memory_order_acq_rel) != 0 || !w->in_stack_.load(std::memory_order_relaxed)) {
+    this->num_stray_unparks_.fetch_add(1, std::memory_order_relaxed);
+  }
+#endif
+  // 先读取external_，exchange之后w可能已经返回并清除了external_
+  if (ExternalPark *external = w->external_.load(std::memory_order_relaxed); external != nullptr) {
+    if (w->state_.exchange(Waiter::kSignaled, std::memory_order_acq_rel) == Waiter::kWaiting) {
+      external->Wake();
+    }
+    return;
+  }
+#if SHANZHAI_TF_NOTIFIER_PARK == SHANZHAI_TF_PARK_CV
+  unsigned state = 0;
+  {
+    std::unique_lock<std::mutex> lock(w->mutex_);
+    state = w->state_.load(std::memory_order_relaxed);
+    w->state_.store(Waiter::kSignaled, std::memory_order_release);
+  }
+  if (state == Waiter::kWaiting) {
+    w->cv_.notify_one();
+  }
+#else
+  // 只有对方已经挂起才需要系统调用
+  const unsigned state = w->state_.exchange(Waiter::kSignaled, std::memory_order_acq_rel);
+#if SHANZHAI_TF_NOTIFIER_PARK == SHANZHAI_TF_PARK_ATOMIC
+  if (state == Waiter::kWaiting) {
+    w->state_.notify_one();
+  } else if (state == Waiter::kTimedWaiting) {
+#if SHANZHAI_TF_NOTIFIER_USE_FUTEX
+    FutexWake(w);
+#else
+    // 对方在mutex_内检查state_后进入wait_until，加锁保证notify_one不会落在两者之间
+    { std::lock_guard<std::mutex> lock(w->mutex_); }
+    w->cv_.notify_one();
+#endif
+  }
+#else
+  if (state == Waiter::kWaiting) {
+    FutexWake(w);
+  }
+#endif
+#endif
+}
+
+template <typename StateT, typename SpinT>
+typename BasicNotifier<StateT, SpinT>::Waiter *BasicNotifier<StateT, SpinT>::GetWaiter(size_t idx) {
   if (idx < this->waiters_.size()) {
     return &this->waiters_[idx];
   }
   return nullptr;
 }
 
+using Notifier = BasicNotifier<NotifierState>;
+using WideNotifier = BasicNotifier<WideNotifierState>;
+using SpinNotifier = BasicNotifier<NotifierState, SpinPolicy<>>;
+
+template <typename StateT, typename SpinT>
+typename BasicNotifier<StateT, SpinT>::SpinStats BasicNotifier<StateT, SpinT>::GetSpinStats() const {
+  SpinStats stats;
+  for (const auto &w : this->waiters_) {
+    stats.num_spin_wakeups += w.num_spin_wakeups_.load(std::memory_order_relaxed);
+    stats.num_park_wakeups += w.num_park_wakeups_.load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+template <typename StateT, typename SpinT>
+typename BasicNotifier<StateT, SpinT>::Stats BasicNotifier<StateT, SpinT>::Snapshot() const {
+  Stats stats;
+#ifdef SHANZHAI_TF_ENABLE_NOTIFIER_STATS
+  for (const auto &w : this->waiters_) {
+    stats.num_prepare_waits += w.num_prepare_waits_.load(std::memory_order_relaxed);
+    stats.num_cancel_waits += w.num_cancel_waits_.load(std::memory_order_relaxed);
+    stats.num_commit_parks += w.num_commit_parks_.load(std::memory_order_relaxed);
+    stats.num_commit_timeouts += w.num_commit_timeouts_.load(std::memory_order_relaxed);
+    stats.num_spurious_wakeups += w.num_spurious_wakeups_.load(std::memory_order_relaxed);
+    stats.num_commit_cas_retries += w.num_commit_cas_retries_.load(std::memory_order_relaxed);
+    stats.num_epoch_yields += w.num_epoch_yields_.load(std::memory_order_relaxed);
+    stats.wake_latency_ns.Merge(w.wake_latency_ns_.Snapshot());
+  }
+  stats.num_notify_cas_retries = this->num_notify_cas_retries_.load(std::memory_order_relaxed);
+  stats.num_stray_unparks = this->num_stray_unparks_.load(std::memory_order_relaxed);
+#endif
+  return stats;
+}
+
+template <typename StateT, typename SpinT>
+bool BasicNotifier<StateT, SpinT>::CheckStack(size_t expected) const {
+  const uint64_t top = this->state_.load(std::memory_order_acquire) & kStackMask;
+  if (top == kStackMask) {
+    return expected == 0;
+  }
+  if (top >= this->waiters_.size()) {
+    return false;  // 包括kStackFrozen
+  }
+  std::vector<bool> seen(this->waiters_.size(), false);
+  size_t n = 0;
+  for (const Waiter *iter = &this->waiters_[top]; iter != nullptr; iter = iter->next_.load(std::memory_order_relaxed)) {
+    const size_t idx = static_cast<size_t>(iter - &this->waiters_[0]);
+    if (seen[idx] || !iter->in_stack_.load(std::memory_order_relaxed)) {
+      return false;
+    }
+    seen[idx] = true;
+    n++;
+  }
+  return n == expected;
+}
+
 }  // namespace shanzhai_tf
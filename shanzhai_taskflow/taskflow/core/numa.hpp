@@ -0,0 +1,184 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace shanzhai_tf {
+
+/*
+NUMA拓扑
+（1）Linux下读取/sys/devices/system/node/online以及每个nodeK/cpulist，
+   只保留当前进程允许运行的cpu（sched_getaffinity），没有可用cpu的节点被丢弃
+（2）读取失败或者非Linux平台时只有一个节点，且cpus_为空，表示不做绑核
+（3）cpulist格式为"0-3,8-11"
+*/
+class NumaTopology {
+ public:
+  struct Node {
+    int id_{0};
+    std::vector<int> cpus_;
+  };
+
+  static NumaTopology Detect();
+
+  // 解析"0-3,8-11"格式的cpu列表，格式错误时返回已经解析的部分
+  static std::vector<int> ParseCpuList(const std::string &list);
+
+  size_t NumNodes() const { return this->nodes_.size(); }
+  const Node &GetNode(size_t idx) const { return this->nodes_[idx]; }
+
+  // 当前线程所在cpu属于的节点下标，无法判断时返回0
+  size_t CurrentNode() const;
+
+  // cpu属于的节点下标，不属于任何节点时返回0
+  size_t NodeOf(int cpu) const;
+
+  // 当前进程允许运行的cpu（sched_getaffinity），平台不支持时为空
+  static std::vector<int> AllowedCpus();
+
+  // 把当前线程绑定到cpus上，cpus为空或者平台不支持时返回false
+  static bool PinThisThread(const std::vector<int> &cpus);
+
+ private:
+  std::vector<Node> nodes_;
+  std::vector<size_t> node_of_cpu_;  // cpu -> nodes_下标
+};
+
+inline std::vector<int> NumaTopology::ParseCpuList(const std::string &list) {
+  std::vector<int> cpus;
+  size_t pos = 0;
+  while (pos < list.size()) {
+    size_t end = list.find(',', pos);
+    if (end == std::string::npos) {
+      end = list.size();
+    }
+    std::string range = list.substr(pos, end - pos);
+    pos = end + 1;
+    while (!range.empty() && (range.back() == '\n' || range.back() == ' ')) {
+      range.pop_back();
+    }
+    if (range.empty()) {
+      continue;
+    }
+    size_t dash = range.find('-');
+    try {
+      int first = std::stoi(range.substr(0, dash));
+      int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+      for (int cpu = first; cpu <= last; cpu++) {
+        cpus.push_back(cpu);
+      }
+    } catch (...) {
+      break;
+    }
+  }
+  return cpus;
+}
+
+inline NumaTopology NumaTopology::Detect() {
+  NumaTopology topology;
+#ifdef __linux__
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  bool has_affinity = sched_getaffinity(0, sizeof(allowed), &allowed) == 0;
+
+  const std::string root = "/sys/devices/system/node/";
+  std::string online;
+  std::ifstream online_file(root + "online");
+  if (std::getline(online_file, online)) {
+    for (int id : ParseCpuList(online)) {
+      std::string cpulist;
+      std::ifstream cpulist_file(root + "node" + std::to_string(id) + "/cpulist");
+      if (!std::getline(cpulist_file, cpulist)) {
+        continue;
+      }
+      Node node;
+      node.id_ = id;
+      for (int cpu : ParseCpuList(cpulist)) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE && (!has_affinity || CPU_ISSET(cpu, &allowed))) {
+          node.cpus_.push_back(cpu);
+        }
+      }
+      if (!node.cpus_.empty()) {
+        topology.nodes_.push_back(std::move(node));
+      }
+    }
+  }
+#endif
+  if (topology.nodes_.empty()) {
+    topology.nodes_.emplace_back();
+  }
+  for (size_t i = 0; i < topology.nodes_.size(); i++) {
+    for (int cpu : topology.nodes_[i].cpus_) {
+      if (static_cast<size_t>(cpu) >= topology.node_of_cpu_.size()) {
+        topology.node_of_cpu_.resize(cpu + 1, 0);
+      }
+      topology.node_of_cpu_[cpu] = i;
+    }
+  }
+  return topology;
+}
+
+inline size_t NumaTopology::CurrentNode() const {
+#ifdef __linux__
+  return this->NodeOf(sched_getcpu());
+#else
+  return 0;
+#endif
+}
+
+inline size_t NumaTopology::NodeOf(int cpu) const {
+  if (cpu >= 0 && static_cast<size_t>(cpu) < this->node_of_cpu_.size()) {
+    return this->node_of_cpu_[cpu];
+  }
+  return 0;
+}
+
+inline std::vector<int> NumaTopology::AllowedCpus() {
+  std::vector<int> cpus;
+#ifdef __linux__
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET(cpu, &allowed)) {
+        cpus.push_back(cpu);
+      }
+    }
+  }
+#endif
+  return cpus;
+}
+
+inline bool NumaTopology::PinThisThread(const std::vector<int> &cpus) {
+#ifdef __linux__
+  if (cpus.empty()) {
+    return false;
+  }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) {
+    if (cpu >= 0 && cpu < CPU_SETSIZE) {
+      CPU_SET(cpu, &set);
+    }
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+  (void)cpus;
+  return false;
+#endif
+}
+
+}  // namespace shanzhai_tf
@@ -0,0 +1,175 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "taskflow/core/cache_line.hpp"
+
+namespace shanzhai_tf {
+
+/*
+按线程缓存的定长对象池，每种T一个全局实例
+（1）每个线程绑定一个Heap，Heap按Slab一次申请一批Block，Block之间通过free_链表串起来
+（2）Animate从当前线程Heap的free_链表取Block，为空时一次性取走remote_链表，仍为空时申请新的Slab
+（3）Recycle时Block属于当前线程的Heap则直接放回free_链表，
+   否则无锁地压入所属Heap的remote_链表（只有所属线程整体取走，不存在ABA）
+（4）线程退出时Heap不会释放，而是交还给ObjectPool，之后新线程可以接管；
+   所有Slab在进程退出时随ObjectPool一起释放，此时对象必须已经全部Recycle
+*/
+template <typename T>
+class ObjectPool {
+  struct Heap;
+
+  struct Block {
+    Heap *heap_;
+    Block *next_;
+    alignas(T) unsigned char storage_[sizeof(T)];
+  };
+
+  struct alignas(kCacheLineSize) Heap {
+    Block *free_{nullptr};
+    alignas(kCacheLineSize) std::atomic<Block *> remote_{nullptr};
+    std::vector<std::unique_ptr<Block[]>> slabs_{};
+  };
+
+  // 线程退出时把Heap交还给ObjectPool
+  struct LocalHeap {
+    Heap *heap_{nullptr};
+    ~LocalHeap() {
+      if (this->heap_ != nullptr) {
+        ObjectPool::Instance().ReleaseHeap(this->heap_);
+      }
+    }
+  };
+
+  // 每个Slab大约64KB
+  static constexpr size_t kBlocksPerSlab = sizeof(Block) >= 4096 ? 16 : (65536 / sizeof(Block));
+
+ public:
+  static ObjectPool &Instance();
+
+  ObjectPool(const ObjectPool &) = delete;
+  ObjectPool &operator=(const ObjectPool &) = delete;
+
+  template <typename... ArgsT>
+  T *Animate(ArgsT &&...args);
+
+  void Recycle(T *ptr);
+
+ private:
+  ObjectPool() = default;
+
+  static LocalHeap &ThisHeap();
+  static Block *ToBlock(T *ptr);
+
+  Heap *AcquireHeap();
+  void ReleaseHeap(Heap *heap);
+  Block *Fetch(Heap *heap);
+
+  std::mutex mutex_;
+  std::vector<std::unique_ptr<Heap>> heaps_{};
+  std::vector<Heap *> idle_heaps_{};
+};
+
+template <typename T>
+ObjectPool<T> &ObjectPool<T>::Instance() {
+  static ObjectPool pool;
+  return pool;
+}
+
+template <typename T>
+typename ObjectPool<T>::LocalHeap &ObjectPool<T>::ThisHeap() {
+  static thread_local LocalHeap local;
+  return local;
+}
+
+template <typename T>
+typename ObjectPool<T>::Block *ObjectPool<T>::ToBlock(T *ptr) {
+  return reinterpret_cast<Block *>(reinterpret_cast<unsigned char *>(ptr) - offsetof(Block, storage_));
+}
+
+template <typename T>
+template <typename... ArgsT>
+T *ObjectPool<T>::Animate(ArgsT &&...args) {
+  LocalHeap &local = ThisHeap();
+  if (local.heap_ == nullptr) {
+    local.heap_ = this->AcquireHeap();
+  }
+  Block *block = this->Fetch(local.heap_);
+  try {
+    return new (block->storage_) T(std::forward<ArgsT>(args)...);
+  } catch (...) {
+    block->next_ = local.heap_->free_;
+    local.heap_->free_ = block;
+    throw;
+  }
+}
+
+template <typename T>
+void ObjectPool<T>::Recycle(T *ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  ptr->~T();
+  Block *block = ToBlock(ptr);
+  Heap *heap = block->heap_;
+  if (heap == ThisHeap().heap_) {
+    block->next_ = heap->free_;
+    heap->free_ = block;
+    return;
+  }
+  Block *head = heap->remote_.load(std::memory_order_relaxed);
+  do {
+    block->next_ = head;
+  } while (!heap->remote_.compare_exchange_weak(head, block, std::memory_order_release, std::memory_order_relaxed));
+}
+
+template <typename T>
+typename ObjectPool<T>::Block *ObjectPool<T>::Fetch(Heap *heap) {
+  if (heap->free_ == nullptr) {
+    heap->free_ = heap->remote_.exchange(nullptr, std::memory_order_acquire);
+  }
+  if (heap->free_ == nullptr) {
+    auto slab = std::make_unique<Block[]>(kBlocksPerSlab);
+    for (size_t i = 0; i < kBlocksPerSlab; i++) {
+      slab[i].heap_ = heap;
+      slab[i].next_ = (i + 1 < kBlocksPerSlab) ? &slab[i + 1] : nullptr;
+    }
+    heap->free_ = &slab[0];
+    heap->slabs_.push_back(std::move(slab));
+  }
+  Block *block = heap->free_;
+  heap->free_ = block->next_;
+  return block;
+}
+
+template <typename T>
+typename ObjectPool<T>::Heap *ObjectPool<T>::AcquireHeap() {
+  std::lock_guard<std::mutex> lock(this->mutex_);
+  if (!this->idle_heaps_.empty()) {
+    Heap *heap = this->idle_heaps_.back();
+    this->idle_heaps_.pop_back();
+    return heap;
+  }
+  this->heaps_.push_back(std::make_unique<Heap>());
+  return this->heaps_.back().get();
+}
+
+template <typename T>
+void ObjectPool<T>::ReleaseHeap(Heap *heap) {
+  std::lock_guard<std::mutex> lock(this->mutex_);
+  this->idle_heaps_.push_back(heap);
+}
+
+}  // namespace shanzhai_tf
@@ -0,0 +1,50 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include "taskflow/core/graph.hpp"
+
+namespace shanzhai_tf {
+
+/*
+传给Observer的Node只读视图，只在回调期间有效
+*/
+class TaskView {
+ public:
+  explicit TaskView(const Node &node) : node_(node) {}
+
+  const std::string &name() const { return this->node_.name_; }
+  TaskPriority priority() const { return this->node_.priority_; }
+
+ private:
+  const Node &node_;
+};
+
+/*
+Executor的观察者，通过Executor::make_observer注册
+（1）set_up在注册时调用一次，之后worker_id都小于num_workers
+（2）on_entry/on_exit在Worker执行任务的前后调用，只由worker_id对应的线程调用；
+   Subflow与Pipeline的join期间Worker会执行其他任务，因此同一个Worker的回调可以嵌套，但总是成对出现
+（3）on_park/on_unpark在Worker挂起到Notifier之前以及被唤醒之后调用，二者之间的时间是Worker的空闲时间
+（4）注册与移除可以和任务并发，此时正在执行的任务以及已经挂起的Worker可能只收到on_exit或on_unpark
+（5）回调在Worker线程的热路径上执行，应当避免加锁与分配内存
+*/
+class ObserverInterface {
+ public:
+  virtual ~ObserverInterface() = default;
+
+  virtual void set_up(size_t num_workers) = 0;
+  virtual void on_entry(size_t worker_id, TaskView tv) = 0;
+  virtual void on_exit(size_t worker_id, TaskView tv) = 0;
+  virtual void on_park(size_t) {}
+  virtual void on_unpark(size_t) {}
+};
+
+}  // namespace shanzhai_tf
@@ -0,0 +1,317 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "taskflow/core/cache_line.hpp"
+#include "taskflow/core/observer.hpp"
+
+namespace shanzhai_tf {
+
+/*
+输出Chrome trace（JSON）格式的Observer，可以用chrome://tracing或者ui.perfetto.dev打开
+（1）每个Worker一条Lane，Lane中是容量为2的幂的环形缓冲区，只由对应的Worker写入，不加锁，
+   写满之后覆盖最早的记录
+（2）on_entry/on_park把开始时间压入Lane的栈，on_exit/on_unpark出栈并写入一个区间，
+   任务区间的cat为task，挂起区间的name与cat为idle，嵌套的区间在同一个tid上叠放
+（3）每个区间是一个seqlock：所有字段都是原子变量，写入前后各修改一次seq_；
+   名字复制到区间内固定长度的缓冲区，超过kMaxNameSize个字节时截断，写入时不分配内存
+（4）dump可以与Worker并发调用，正在写入或者读取期间被覆盖的区间会被跳过，其余区间都是完整的，
+   wait_for_all之后调用时输出全部保留的区间
+（5）一个ChromeTracer只能注册到一个Executor
+*/
+class ChromeTracer : public ObserverInterface {
+  friend class Profiler;
+
+ public:
+  explicit ChromeTracer(size_t capacity = 1 << 16);
+
+  void set_up(size_t num_workers) override;
+  void on_entry(size_t worker_id, TaskView tv) override;
+  void on_exit(size_t worker_id, TaskView tv) override;
+  void on_park(size_t worker_id) override;
+  void on_unpark(size_t worker_id) override;
+
+  // 输出一个完整的JSON文档
+  void dump(std::ostream &os) const;
+
+  // 各Lane保留的区间数量之和，以及被覆盖的区间数量之和
+  size_t num_spans() const;
+  size_t num_dropped() const;
+
+ private:
+  enum class SpanType : uint8_t {
+    TASK,
+    IDLE,
+  };
+
+  static constexpr size_t kMaxNameSize = 32;
+
+  // 第i个区间写入时seq_为2 * i + 1，写完之后为2 * i + 2；
+  // 字段以release写入、acquire读取，读者读到的字段来自后续写入时再次读取的seq_一定已经改变
+  struct Span {
+    std::atomic<uint64_t> seq_{0};
+    std::atomic<int64_t> beg_{0};
+    std::atomic<int64_t> end_{0};
+    std::atomic<uint32_t> name_size_{0};
+    std::atomic<SpanType> type_{SpanType::TASK};
+    std::array<std::atomic<uint64_t>, kMaxNameSize / sizeof(uint64_t)> name_{};
+  };
+
+  struct alignas(kCacheLineSize) Lane {
+    std::unique_ptr<Span[]> ring_;
+    std::vector<int64_t> stack_;
+    std::atomic<uint64_t> head_{0};  // 已写入的区间总数
+  };
+
+  // 相对进程内第一次调用的纳秒数，所有ChromeTracer共用一个起点
+  static int64_t Now();
+  static void WriteString(std::ostream &os, const std::string &s);
+  static void WriteMicros(std::ostream &os, int64_t ns);
+
+  // 输出traceEvents数组的元素，pid区分不同的Executor，first为true时前面不输出逗号
+  void DumpEvents(std::ostream &os, size_t pid, bool &first) const;
+
+  void Begin(size_t worker_id);
+  void End(size_t worker_id, SpanType type, const std::string &name);
+
+  size_t capacity_;
+  std::vector<Lane, AlignedAllocator<Lane>> lanes_;
+};
+
+/*
+TF_ENABLE_PROFILER=file.json时每个Executor构造时创建一个ChromeTracer，
+进程退出时把所有ChromeTracer写入同一个文件，第i个创建的Executor的pid为i
+（1）Executor在构造时调用Instance，静态的Executor也会在Profiler之前析构
+（2）Dump可以随时把目前的记录写入文件，与Worker并发时跳过正在写入的区间，见ChromeTracer（4），
+   进程退出时会再写一次完整的记录
+*/
+class Profiler {
+ public:
+  static Profiler &Instance();
+
+  ~Profiler();
+
+  Profiler(const Profiler &) = delete;
+  Profiler &operator=(const Profiler &) = delete;
+
+  // 没有设置TF_ENABLE_PROFILER时返回nullptr
+  std::shared_ptr<ChromeTracer> NewTracer();
+
+  void Dump();
+
+ private:
+  Profiler();
+
+  std::string path_;
+  std::mutex mutex_;
+  std::vector<std::shared_ptr<ChromeTracer>> tracers_;
+};
+
+inline ChromeTracer::ChromeTracer(size_t capacity) : capacity_(1) {
+  while (this->capacity_ < capacity) {
+    this->capacity_ <<= 1;
+  }
+}
+
+inline void ChromeTracer::set_up(size_t num_workers) {
+  this->lanes_ = std::vector<Lane, AlignedAllocator<Lane>>(num_workers);
+  for (auto &lane : this->lanes_) {
+    lane.ring_ = std::make_unique<Span[]>(this->capacity_);
+    lane.stack_.reserve(16);
+  }
+}
+
+inline void ChromeTracer::on_entry(size_t worker_id, TaskView) { this->Begin(worker_id); }
+
+inline void ChromeTracer::on_exit(size_t worker_id, TaskView tv) { this->End(worker_id, SpanType::TASK, tv.name()); }
+
+inline void ChromeTracer::on_park(size_t worker_id) { this->Begin(worker_id); }
+
+inline void ChromeTracer::on_unpark(size_t worker_id) {
+  static const std::string kIdle = "idle";
+  this->End(worker_id, SpanType::IDLE, kIdle);
+}
+
+inline int64_t ChromeTracer::Now() {
+  static const auto origin = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+inline void ChromeTracer::Begin(size_t worker_id) { this->lanes_[worker_id].stack_.push_back(Now()); }
+
+// 注册之前开始的区间没有开始时间，直接忽略
+inline void ChromeTracer::End(size_t worker_id, SpanType type, const std::string &name) {
+  Lane &lane = this->lanes_[worker_id];
+  if (lane.stack_.empty()) {
+    return;
+  }
+  uint64_t head = lane.head_.load(std::memory_order_relaxed);
+  Span &span = lane.ring_[head & (this->capacity_ - 1)];
+  std::array<uint64_t, kMaxNameSize / sizeof(uint64_t)> words{};
+  const size_t size = std::min(name.size(), kMaxNameSize);
+  std::memcpy(words.data(), name.data(), size);
+
+  span.seq_.store(2 * head + 1, std::memory_order_relaxed);
+  span.beg_.store(lane.stack_.back(), std::memory_order_release);
+  span.end_.store(Now(), std::memory_order_release);
+  span.name_size_.store(static_cast<uint32_t>(size), std::memory_order_release);
+  span.type_.store(type, std::memory_order_release);
+  for (size_t i = 0; i < words.size(); i++) {
+    span.name_[i].store(words[i], std::memory_order_release);
+  }
+  span.seq_.store(2 * head + 2, std::memory_order_release);
+  lane.stack_.pop_back();
+  lane.head_.store(head + 1, std::memory_order_release);
+}
+
+inline void ChromeTracer::dump(std::ostream &os) const {
+  bool first = true;
+  os << "{\"traceEvents\":[";
+  this->DumpEvents(os, 0, first);
+  os << "\n]}\n";
+}
+
+inline size_t ChromeTracer::num_spans() const {
+  size_t num = 0;
+  for (auto &lane : this->lanes_) {
+    num += std::min<uint64_t>(lane.head_.load(std::memory_order_acquire), this->capacity_);
+  }
+  return num;
+}
+
+inline size_t ChromeTracer::num_dropped() const {
+  size_t num = 0;
+  for (auto &lane : this->lanes_) {
+    uint64_t head = lane.head_.load(std::memory_order_acquire);
+    num += head > this->capacity_ ? head - this->capacity_ : 0;
+  }
+  return num;
+}
+
+inline void ChromeTracer::DumpEvents(std::ostream &os, size_t pid, bool &first) const {
+  for (size_t tid = 0; tid < this->lanes_.size(); tid++) {
+    os << (first ? "\n" : ",\n");
+    first = false;
+    os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << pid << ",\"tid\":" << tid
+       << ",\"args\":{\"name\":\"worker " << tid << "\"}}";
+
+    const Lane &lane = this->lanes_[tid];
+    uint64_t head = lane.head_.load(std::memory_order_acquire);
+    uint64_t tail = head > this->capacity_ ? head - this->capacity_ : 0;
+    std::string name;
+    name.reserve(kMaxNameSize);
+    for (uint64_t i = tail; i < head; i++) {
+      const Span &span = lane.ring_[i & (this->capacity_ - 1)];
+      // 先读seq_再读字段，最后确认seq_没有变化；不是第i个区间说明正在写入或者已经被覆盖
+      const uint64_t seq = span.seq_.load(std::memory_order_acquire);
+      if (seq != 2 * i + 2) {
+        continue;
+      }
+      const int64_t beg = span.beg_.load(std::memory_order_acquire);
+      const int64_t end = span.end_.load(std::memory_order_acquire);
+      const size_t size = std::min<size_t>(span.name_size_.load(std::memory_order_acquire), kMaxNameSize);
+      const bool idle = span.type_.load(std::memory_order_acquire) == SpanType::IDLE;
+      std::array<uint64_t, kMaxNameSize / sizeof(uint64_t)> words{};
+      for (size_t j = 0; j < words.size(); j++) {
+        words[j] = span.name_[j].load(std::memory_order_acquire);
+      }
+      if (span.seq_.load(std::memory_order_relaxed) != seq) {
+        continue;
+      }
+      name.assign(reinterpret_cast<const char *>(words.data()), size);
+
+      os << ",\n{\"name\":";
+      WriteString(os, name.empty() ? std::string("task") : name);
+      os << ",\"cat\":\"" << (idle ? "idle" : "task") << "\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << tid
+         << ",\"ts\":";
+      WriteMicros(os, beg);
+      os << ",\"dur\":";
+      WriteMicros(os, end - beg);
+      os << "}";
+    }
+  }
+}
+
+inline void ChromeTracer::WriteString(std::ostream &os, const std::string &s) {
+  os << '"';
+  for (char c : s) {
+    if (c == '"' || c == '\\') {
+      os << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      char buf[8];
+      std::snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned>(c));
+      os << buf;
+    } else {
+      os << c;
+    }
+  }
+  os << '"';
+}
+
+// Chrome trace的时间单位为微秒，保留到纳秒
+inline void ChromeTracer::WriteMicros(std::ostream &os, int64_t ns) {
+  char buf[32];
+  std::snprintf(buf, sizeof(buf), "%lld.%03lld", static_cast<long long>(ns / 1000), static_cast<long long>(ns % 1000));
+  os << buf;
+}
+
+inline Profiler &Profiler::Instance() {
+  static Profiler profiler;
+  return profiler;
+}
+
+inline Profiler::Profiler() {
+  if (const char *path = std::getenv("TF_ENABLE_PROFILER"); path != nullptr) {
+    this->path_ = path;
+  }
+}
+
+inline Profiler::~Profiler() { this->Dump(); }
+
+inline std::shared_ptr<ChromeTracer> Profiler::NewTracer() {
+  if (this->path_.empty()) {
+    return nullptr;
+  }
+  auto tracer = std::make_shared<ChromeTracer>();
+  std::lock_guard<std::mutex> lock(this->mutex_);
+  this->tracers_.push_back(tracer);
+  return tracer;
+}
+
+inline void Profiler::Dump() {
+  std::lock_guard<std::mutex> lock(this->mutex_);
+  if (this->path_.empty() || this->tracers_.empty()) {
+    return;
+  }
+  std::ofstream ofs(this->path_);
+  if (!ofs) {
+    return;
+  }
+  bool first = true;
+  ofs << "{\"traceEvents\":[";
+  for (size_t pid = 0; pid < this->tracers_.size(); pid++) {
+    this->tracers_[pid]->DumpEvents(ofs, pid, first);
+  }
+  ofs << "\n]}\n";
+}
+
+}  // namespace shanzhai_tf
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <mutex>
+
+#include "taskflow/core/graph.hpp"
+
+namespace shanzhai_tf {
+
+/*
+限制同时执行的任务数量，通过Task::acquire/Task::release声明
+（1）Worker执行Node之前按acquire的顺序获取所有Semaphore，某个Semaphore没有可用数量时，
+   先归还已经获取的Semaphore，再把Node挂到这个Semaphore的等待队列上，Worker继续执行其他任务；
+   挂起时Semaphore又有了可用数量则不挂起，从头重新获取；
+   挂起的Node仍然计入Topology，wait/wait_for_all会等待它执行
+（2）Node执行完之后归还release声明的Semaphore，每归还一个可用数量就把等待队列中的第一个Node
+   放回归还者的本地队列，被放回的Node重新获取所有Semaphore，失败时再次挂起
+（3）等待队列是经过Node::next_waiter_的侵入式链表，挂起与唤醒都不分配内存
+（4）Semaphore的生命周期必须覆盖所有使用它的Taskflow的运行
+（5）被取消的运行跳过的Node不获取Semaphore，被唤醒的Node被跳过时通过Handoff把唤醒交给等待队列中的下一个Node
+*/
+class Semaphore {
+  friend class Executor;
+
+ public:
+  explicit Semaphore(size_t max_value) : max_value_(max_value), value_(max_value) {}
+
+  Semaphore(const Semaphore &) = delete;
+  Semaphore &operator=(const Semaphore &) = delete;
+
+  // 当前可用的数量
+  size_t value() const;
+  size_t max_value() const { return this->max_value_; }
+
+ private:
+  bool TryAcquire();
+  // 没有可用数量时把node加入等待队列并返回true，之后调用者不能再访问node
+  bool Wait(Node *node);
+  // 归还一个可用数量，返回需要重新调度的Node，没有等待的Node时返回nullptr
+  Node *Release();
+  // 有可用数量时取出等待队列中的第一个Node，不改变可用数量
+  Node *Handoff();
+
+  // 在mutex_内调用
+  Node *PopWaiter();
+
+  mutable std::mutex mutex_;
+  const size_t max_value_;
+  size_t value_;
+  Node *head_{nullptr};
+  Node *tail_{nullptr};
+};
+
+inline size_t Semaphore::value() const {
+  std::lock_guard<std::mutex> lock(this->mutex_);
+  return this->value_;
+}
+
+inline bool Semaphore::TryAcquire() {
+  std::lock_guard<std::mutex> lock(this->mutex_);
+  if (this->value_ == 0) {
+    return false;
+  }
+  this->value_--;
+  return true;
+}
+
+inline bool Semaphore::Wait(Node *node) {
+  std::lock_guard<std::mutex> lock(this->mutex_);
+  if (this->value_ > 0) {
+    return false;
+  }
+  node->next_waiter_ = nullptr;
+  if (this->tail_ == nullptr) {
+    this->head_ = node;
+  } else {
+    this->tail_->next_waiter_ = node;
+  }
+  this->tail_ = node;
+  return true;
+}
+
+inline Node *Semaphore::Release() {
+  std::lock_guard<std::mutex> lock(this->mutex_);
+  assert(this->value_ < this->max_value_);  // release的次数多于acquire
+  this->value_++;
+  return this->PopWaiter();
+}
+
+inline Node *Semaphore::Handoff() {
+  std::lock_guard<std::mutex> lock(this->mutex_);
+  return this->value_ > 0 ? this->PopWaiter() : nullptr;
+}
+
+inline Node *Semaphore::PopWaiter() {
+  Node *node = this->head_;
+  if (node != nullptr) {
+    this->head_ = node->next_waiter_;
+    if (this->head_ == nullptr) {
+      this->tail_ = nullptr;
+    }
+  }
+  return node;
+}
+
+}  // namespace shanzhai_tf
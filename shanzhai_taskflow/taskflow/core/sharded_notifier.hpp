@@ -0,0 +1,137 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "taskflow/core/notifier.hpp"
+
+namespace shanzhai_tf {
+
+/*
+按分片（通常是NUMA节点）拆分的Notifier，每个分片拥有独立的state_，
+同一分片的Waiter只会修改本分片的state_，避免所有线程跨socket争抢同一条缓存行
+（1）构造时给出每个Waiter所属的分片，GetWaiter(idx)返回的Waiter记录了分片下标
+（2）PrepareWait/CommitWait/CancelWait只访问Waiter所在分片
+（3）Notify(false, home)先尝试唤醒home分片，没有Waiter时依次尝试后面的分片
+   NotifyN(n, home)从home分片开始，本分片唤醒不足n个时剩余数量溢出到后面的分片
+   Notify(true)唤醒所有分片
+   NotifyWaiter、IsParked只访问目标Waiter所在分片
+（4）不丢失唤醒：生产者先发布任务再Notify，检查某个分片时没有Waiter，
+   说明之后在该分片PrepareWait的线程一定能看到已经发布的任务
+*/
+template <typename NotifierT = Notifier>
+class ShardedNotifier {
+ public:
+  struct Waiter {
+    size_t shard_{0};
+    typename NotifierT::Waiter *waiter_{nullptr};
+  };
+
+  // shard_of_waiter[i]为第i个Waiter所属的分片，分片下标必须连续且每个分片至少有一个Waiter
+  explicit ShardedNotifier(const std::vector<size_t> &shard_of_waiter);
+
+  void PrepareWait(Waiter *w) { this->shards_[w->shard_]->PrepareWait(w->waiter_); }
+  void CommitWait(Waiter *w) { this->shards_[w->shard_]->CommitWait(w->waiter_); }
+  template <typename Rep, typename Period>
+  bool CommitWaitFor(Waiter *w, const std::chrono::duration<Rep, Period> &timeout) {
+    return this->shards_[w->shard_]->CommitWaitFor(w->waiter_, timeout);
+  }
+  template <typename C, typename Duration>
+  bool CommitWaitUntil(Waiter *w, const std::chrono::time_point<C, Duration> &deadline) {
+    return this->shards_[w->shard_]->CommitWaitUntil(w->waiter_, deadline);
+  }
+  void CancelWait(Waiter *w) { this->shards_[w->shard_]->CancelWait(w->waiter_); }
+
+  size_t Notify(bool all) { return this->Notify(all, 0); }
+  size_t Notify(bool all, size_t home);
+  size_t NotifyN(size_t n) { return this->NotifyN(n, 0); }
+  size_t NotifyN(size_t n, size_t home);
+  bool NotifyWaiter(Waiter *w) { return this->shards_[w->shard_]->NotifyWaiter(w->waiter_); }
+  bool NotifyIndex(size_t idx) { return this->NotifyWaiter(&this->waiters_[idx]); }
+  bool IsParked(const Waiter *w) const { return this->shards_[w->shard_]->IsParked(w->waiter_); }
+
+  Waiter *GetWaiter(size_t idx);
+
+  void SetExternalPark(Waiter *w, ExternalPark *external) {
+    this->shards_[w->shard_]->SetExternalPark(w->waiter_, external);
+  }
+
+  size_t NumShards() const { return this->shards_.size(); }
+  NotifierT &GetShard(size_t idx) { return *this->shards_[idx]; }
+
+ private:
+  std::vector<std::unique_ptr<NotifierT>> shards_;
+  std::vector<Waiter> waiters_;
+};
+
+template <typename NotifierT>
+ShardedNotifier<NotifierT>::ShardedNotifier(const std::vector<size_t> &shard_of_waiter)
+    : waiters_(shard_of_waiter.size()) {
+  std::vector<size_t> sizes;
+  for (auto shard : shard_of_waiter) {
+    if (shard >= sizes.size()) {
+      sizes.resize(shard + 1, 0);
+    }
+    sizes[shard]++;
+  }
+  if (sizes.empty()) {
+    sizes.push_back(0);
+  }
+  for (auto size : sizes) {
+    assert(size > 0 || shard_of_waiter.empty());
+    this->shards_.push_back(std::make_unique<NotifierT>(size));
+  }
+  std::vector<size_t> next(sizes.size(), 0);
+  for (size_t i = 0; i < shard_of_waiter.size(); i++) {
+    size_t shard = shard_of_waiter[i];
+    this->waiters_[i].shard_ = shard;
+    this->waiters_[i].waiter_ = this->shards_[shard]->GetWaiter(next[shard]++);
+  }
+}
+
+template <typename NotifierT>
+size_t ShardedNotifier<NotifierT>::Notify(bool all, size_t home) {
+  const size_t num_shards = this->shards_.size();
+  if (all) {
+    size_t num = 0;
+    for (auto &shard : this->shards_) {
+      num += shard->Notify(true);
+    }
+    return num;
+  }
+  for (size_t i = 0; i < num_shards; i++) {
+    if (this->shards_[(home + i) % num_shards]->Notify(false) > 0) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+template <typename NotifierT>
+size_t ShardedNotifier<NotifierT>::NotifyN(size_t n, size_t home) {
+  const size_t num_shards = this->shards_.size();
+  size_t num = 0;
+  for (size_t i = 0; i < num_shards && num < n; i++) {
+    num += this->shards_[(home + i) % num_shards]->NotifyN(n - num);
+  }
+  return num;
+}
+
+template <typename NotifierT>
+typename ShardedNotifier<NotifierT>::Waiter *ShardedNotifier<NotifierT>::GetWaiter(size_t idx) {
+  if (idx < this->waiters_.size()) {
+    return &this->waiters_[idx];
+  }
+  return nullptr;
+}
+
+}  // namespace shanzhai_tf
@@ -0,0 +1,154 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace shanzhai_tf {
+
+template <typename Signature, size_t InlineSize = 64>
+class SmallFunction;
+
+/*
+只能移动的类型擦除可调用对象，用来代替热路径上的std::function
+（1）可调用对象不超过InlineSize字节、对齐不超过max_align_t且移动不抛异常时直接构造在storage_中，
+   否则在堆上分配，storage_中只保存指针
+（2）ops_指向每个类型一份的静态函数表；relocate_为nullptr表示按字节拷贝storage_的前size_字节完成移动，
+   平凡可拷贝的对象以及堆上对象的指针都是这种情况，destroy_为nullptr表示不需要析构
+（3）不要求可拷贝，std::unique_ptr等只能移动的捕获可以直接移入
+（4）operator()不是const，同一个对象被多个线程同时调用时由调用方保证安全
+*/
+template <typename R, typename... Args, size_t InlineSize>
+class SmallFunction<R(Args...), InlineSize> {
+  static_assert(InlineSize >= sizeof(void *), "InlineSize must hold at least a pointer");
+
+  struct Ops {
+    R (*invoke_)(void *, Args &&...);
+    void (*relocate_)(void *, void *);
+    void (*destroy_)(void *);
+    size_t size_;  // relocate_为nullptr时需要拷贝的字节数
+  };
+
+ public:
+  template <typename F>
+  static constexpr bool kStoredInline = sizeof(F) <= InlineSize && alignof(F) <= alignof(std::max_align_t) &&
+                                        std::is_nothrow_move_constructible_v<F>;
+
+  SmallFunction() = default;
+  SmallFunction(std::nullptr_t) {}  // NOLINT
+
+  template <typename F, typename D = std::decay_t<F>,
+            std::enable_if_t<!std::is_same_v<D, SmallFunction> && std::is_invocable_r_v<R, D &, Args...>, void> * =
+                nullptr>
+  SmallFunction(F &&f) {  // NOLINT
+    if constexpr (std::is_pointer_v<D> || std::is_member_pointer_v<D>) {
+      if (!f) {
+        return;
+      }
+    }
+    if constexpr (kStoredInline<D>) {
+      new (this->storage_) D(std::forward<F>(f));
+      this->ops_ = &kInlineOps<D>;
+    } else {
+      *reinterpret_cast<D **>(this->storage_) = new D(std::forward<F>(f));
+      this->ops_ = &kHeapOps<D>;
+    }
+  }
+
+  ~SmallFunction() { this->Reset(); }
+
+  SmallFunction(const SmallFunction &) = delete;
+  SmallFunction &operator=(const SmallFunction &) = delete;
+  SmallFunction(SmallFunction &&other) noexcept { this->MoveFrom(other); }
+  SmallFunction &operator=(SmallFunction &&other) noexcept;
+  SmallFunction &operator=(std::nullptr_t) {
+    this->Reset();
+    return *this;
+  }
+
+  explicit operator bool() const { return this->ops_ != nullptr; }
+
+  R operator()(Args... args) { return this->ops_->invoke_(this->storage_, std::forward<Args>(args)...); }
+
+ private:
+  template <typename F>
+  static R InvokeInline(void *p, Args &&...args) {
+    return std::invoke(*std::launder(reinterpret_cast<F *>(p)), std::forward<Args>(args)...);
+  }
+  template <typename F>
+  static R InvokeHeap(void *p, Args &&...args) {
+    return std::invoke(**reinterpret_cast<F **>(p), std::forward<Args>(args)...);
+  }
+  template <typename F>
+  static void RelocateInline(void *dst, void *src) {
+    F *from = std::launder(reinterpret_cast<F *>(src));
+    new (dst) F(std::move(*from));
+    from->~F();
+  }
+  template <typename F>
+  static void DestroyInline(void *p) {
+    std::launder(reinterpret_cast<F *>(p))->~F();
+  }
+  template <typename F>
+  static void DestroyHeap(void *p) {
+    delete *reinterpret_cast<F **>(p);
+  }
+
+  template <typename F>
+  static constexpr Ops kInlineOps = {
+      &InvokeInline<F>,
+      std::is_trivially_copyable_v<F> ? nullptr : &RelocateInline<F>,
+      std::is_trivially_destructible_v<F> ? nullptr : &DestroyInline<F>,
+      sizeof(F),
+  };
+  template <typename F>
+  static constexpr Ops kHeapOps = {&InvokeHeap<F>, nullptr, &DestroyHeap<F>, sizeof(F *)};
+
+  void MoveFrom(SmallFunction &other) noexcept;
+  void Reset();
+
+  alignas(std::max_align_t) unsigned char storage_[InlineSize];
+  const Ops *ops_{nullptr};
+};
+
+template <typename R, typename... Args, size_t InlineSize>
+SmallFunction<R(Args...), InlineSize> &SmallFunction<R(Args...), InlineSize>::operator=(SmallFunction &&other) noexcept {
+  if (this != &other) {
+    this->Reset();
+    this->MoveFrom(other);
+  }
+  return *this;
+}
+
+template <typename R, typename... Args, size_t InlineSize>
+void SmallFunction<R(Args...), InlineSize>::MoveFrom(SmallFunction &other) noexcept {
+  if (other.ops_ == nullptr) {
+    return;
+  }
+  if (other.ops_->relocate_ == nullptr) {
+    std::memcpy(this->storage_, other.storage_, other.ops_->size_);
+  } else {
+    other.ops_->relocate_(this->storage_, other.storage_);
+  }
+  this->ops_ = other.ops_;
+  other.ops_ = nullptr;
+}
+
+template <typename R, typename... Args, size_t InlineSize>
+void SmallFunction<R(Args...), InlineSize>::Reset() {
+  if (this->ops_ != nullptr && this->ops_->destroy_ != nullptr) {
+    this->ops_->destroy_(this->storage_);
+  }
+  this->ops_ = nullptr;
+}
+
+}  // namespace shanzhai_tf
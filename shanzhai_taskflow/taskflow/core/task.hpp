@@ -0,0 +1,119 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "taskflow/core/graph.hpp"
+#include "taskflow/core/semaphore.hpp"
+
+namespace shanzhai_tf {
+
+/*
+Node的轻量句柄，用于连接依赖关系，不拥有Node
+*/
+class Task {
+  friend class FlowBuilder;
+
+ public:
+  Task() = default;
+
+  // this在tasks之前执行
+  template <typename... Ts>
+  Task &precede(Ts &&...tasks);
+
+  // this在tasks之后执行
+  template <typename... Ts>
+  Task &succeed(Ts &&...tasks);
+
+  Task &name(const std::string &name);
+  const std::string &name() const;
+
+  Task &priority(TaskPriority priority);
+  TaskPriority priority() const;
+
+  // 执行之前获取semaphore，可以多次调用获取多个Semaphore
+  Task &acquire(Semaphore &semaphore);
+  // 执行之后归还semaphore，可以归还其他Task获取的Semaphore
+  Task &release(Semaphore &semaphore);
+
+  size_t num_successors() const;
+  size_t num_dependents() const;
+
+  bool empty() const;
+
+  bool operator==(const Task &rhs) const { return this->node_ == rhs.node_; }
+  bool operator!=(const Task &rhs) const { return this->node_ != rhs.node_; }
+
+ private:
+  explicit Task(Node *node) : node_(node) {}
+
+  NodeSemaphores &Semaphores();
+
+  Node *node_{nullptr};
+};
+
+template <typename... Ts>
+Task &Task::precede(Ts &&...tasks) {
+  (this->node_->Precede(tasks.node_), ...);
+  return *this;
+}
+
+template <typename... Ts>
+Task &Task::succeed(Ts &&...tasks) {
+  (tasks.node_->Precede(this->node_), ...);
+  return *this;
+}
+
+inline Task &Task::name(const std::string &name) {
+  this->node_->name_ = name;
+  return *this;
+}
+
+inline const std::string &Task::name() const { return this->node_->name_; }
+
+inline Task &Task::priority(TaskPriority priority) {
+  this->node_->priority_ = priority;
+  return *this;
+}
+
+inline TaskPriority Task::priority() const { return this->node_->priority_; }
+
+inline Task &Task::acquire(Semaphore &semaphore) {
+  auto &semaphores = this->Semaphores();
+  semaphores.to_acquire_.push_back(&semaphore);
+  semaphores.paired_ = std::is_permutation(semaphores.to_acquire_.begin(), semaphores.to_acquire_.end(),
+                                           semaphores.to_release_.begin(), semaphores.to_release_.end());
+  return *this;
+}
+
+inline Task &Task::release(Semaphore &semaphore) {
+  auto &semaphores = this->Semaphores();
+  semaphores.to_release_.push_back(&semaphore);
+  semaphores.paired_ = std::is_permutation(semaphores.to_acquire_.begin(), semaphores.to_acquire_.end(),
+                                           semaphores.to_release_.begin(), semaphores.to_release_.end());
+  return *this;
+}
+
+inline NodeSemaphores &Task::Semaphores() {
+  if (this->node_->semaphores_ == nullptr) {
+    this->node_->semaphores_ = std::make_unique<NodeSemaphores>();
+  }
+  return *this->node_->semaphores_;
+}
+
+inline size_t Task::num_successors() const { return this->node_->successors_.size(); }
+
+inline size_t Task::num_dependents() const { return this->node_->num_dependents_; }
+
+inline bool Task::empty() const { return this->node_ == nullptr; }
+
+}  // namespace shanzhai_tf
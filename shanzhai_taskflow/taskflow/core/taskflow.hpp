@@ -0,0 +1,88 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "taskflow/core/flow_builder.hpp"
+#include "taskflow/core/graph.hpp"
+#include "taskflow/core/object_pool.hpp"
+#include "taskflow/core/topology.hpp"
+
+namespace shanzhai_tf {
+
+/*
+静态任务图，通过emplace添加任务、precede/succeed连接依赖后交给Executor::run运行，
+图不变时可以重复运行，运行期间Taskflow必须存活且不能修改
+（1）同一个Taskflow可以同时运行多次，也可以通过composed_of作为模块嵌入其他Taskflow，
+   每次运行从topologies_中取一个空闲的Topology，不复制Graph，见topology.hpp；
+   同时运行时同一个任务的可调用对象会被并发调用
+*/
+class Taskflow : public FlowBuilder {
+  friend class Executor;
+
+ public:
+  explicit Taskflow(const std::string &name = "") : FlowBuilder(graph_), name_(name) {}
+  ~Taskflow();
+
+  Taskflow(const Taskflow &) = delete;
+  Taskflow &operator=(const Taskflow &) = delete;
+
+  const std::string &name() const { return this->name_; }
+  void name(const std::string &name) { this->name_ = name; }
+
+  size_t num_tasks() const { return this->graph_.Size(); }
+  bool empty() const { return this->graph_.Empty(); }
+  void clear() { this->graph_.Clear(); }
+
+ private:
+  // 取一个空闲的Topology，优先primary，没有空闲的时新建
+  Topology *AcquireTopology();
+  void ReleaseTopology(Topology *tp);
+
+  Graph graph_{};
+  std::string name_{};
+
+  std::mutex topology_mutex_;
+  std::vector<Topology *> topologies_{};  // 第一个是primary
+  std::vector<Topology *> idle_{};
+};
+
+inline Taskflow::~Taskflow() {
+  assert(this->idle_.size() == this->topologies_.size());  // 运行期间不能销毁
+  auto &pool = ObjectPool<Topology>::Instance();
+  for (auto tp : this->topologies_) {
+    pool.Recycle(tp);
+  }
+}
+
+inline Topology *Taskflow::AcquireTopology() {
+  std::lock_guard<std::mutex> lock(this->topology_mutex_);
+  if (this->idle_.empty()) {
+    this->topologies_.push_back(ObjectPool<Topology>::Instance().Animate(*this, this->topologies_.empty()));
+    return this->topologies_.back();
+  }
+  auto it = std::find_if(this->idle_.begin(), this->idle_.end(), [](Topology *tp) { return tp->primary_; });
+  if (it == this->idle_.end()) {
+    it = this->idle_.end() - 1;
+  }
+  Topology *tp = *it;
+  this->idle_.erase(it);
+  return tp;
+}
+
+inline void Taskflow::ReleaseTopology(Topology *tp) {
+  std::lock_guard<std::mutex> lock(this->topology_mutex_);
+  this->idle_.push_back(tp);
+}
+
+}  // namespace shanzhai_tf
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "taskflow/core/cache_line.hpp"
+#include "taskflow/core/graph.hpp"
+#include "taskflow/core/object_pool.hpp"
+
+namespace shanzhai_tf {
+
+class Executor;
+class Taskflow;
+
+/*
+Taskflow的一次运行（或者一次作为模块的运行）所需的状态，由Taskflow缓存，空闲时被下一次运行取走
+（1）Taskflow的第一个Topology是primary，直接使用Graph中的Node保存运行时状态，和只运行一次时没有区别；
+   primary正在使用时再次运行，由Taskflow取一个空闲的Topology或者新建一个，
+   非primary的Topology第一次使用时为每个Node从ObjectPool<Node>分配一个实例（instances_），
+   之后重复使用，不复制可调用对象与后继，因此同一个Graph可以同时运行多次
+（2）run_n的n次运行在同一个Topology上依次执行，num_submitted_为已提交次数，num_finished_为已完成次数；
+   Topology被归还后下一次运行继续累加这两个计数，之前的RunFuture不受影响
+（3）join_counter_为当前这次运行中已调度但还没执行完的Node数量，减到0说明本次运行结束，
+   经过条件任务时有的Node不会执行，有的Node会执行多次
+（4）sources_为本次运行中没有前驱的Node（primary为Graph中的Node，否则为实例），每次运行开始时重新计算，复用已有容量
+（5）cancelled_由RunFuture::cancel设置，Worker执行每个Node之前relaxed load一次，
+   与只读的字段放在一起，不和频繁修改的join_counter_共享cache line；本次运行结束时在mutex_内清除
+（6）held_记录本次运行中acquire与release不成对的Node（一个Node获取、另一个Node归还）对每个Semaphore的净获取数量，
+   num_semaphore_waiters_为挂在Semaphore等待队列上的Node数量，都由semaphore_mutex_保护；
+   被取消的运行用它们找出再也不会被归还的Semaphore，见executor.hpp
+*/
+class Topology {
+  friend class Executor;
+  friend class RunFuture;
+  friend class Taskflow;
+
+ public:
+  Topology(Taskflow &taskflow, bool primary) : taskflow_(taskflow), primary_(primary) {}
+  ~Topology();
+
+ private:
+  Taskflow &taskflow_;
+  const bool primary_;
+  Executor *executor_{nullptr};
+  std::atomic<bool> cancelled_{false};
+
+  alignas(kCacheLineSize) std::atomic<size_t> join_counter_{0};
+  std::vector<Node *> sources_{};
+  std::vector<Node *> instances_{};
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  uint64_t num_submitted_{0};
+  uint64_t num_finished_{0};
+
+  std::mutex semaphore_mutex_;
+  size_t num_semaphore_waiters_{0};
+  std::vector<std::pair<Semaphore *, int64_t>> held_{};
+};
+
+inline Topology::~Topology() {
+  auto &pool = ObjectPool<Node>::Instance();
+  for (auto node : this->instances_) {
+    pool.Recycle(node);
+  }
+}
+
+/*
+Executor::run的返回值，等待对应的那次运行结束，不分配内存
+（1）cancel之后还没有开始执行的Node都被跳过：不执行、不调度后继，但仍按完成计数，
+   正在执行的Node不会被打断，wait在它们结束后返回；run_n剩余的运行同样被跳过
+（2）被跳过的Node不获取也不归还Semaphore。一个Node获取、后面的Node归还的Semaphore，
+   归还的Node被跳过时由Executor在本次运行没有正在执行的Node之后代为归还，之前的Node已经执行完，
+   排在这些Semaphore上的Node（包括本次运行中的）不会因此永远挂起；
+   例外是Subflow/模块/Pipeline的子任务：父Node等待子任务期间算作正在执行，
+   子任务排在本次运行中其他子任务没有归还的Semaphore上时仍然会挂起
+*/
+class RunFuture {
+  friend class Executor;
+
+ public:
+  RunFuture() = default;
+
+  void wait() const;
+  bool ready() const;
+  // 请求取消这次运行，运行已经结束时返回false；定义在executor.hpp
+  bool cancel();
+
+ private:
+  RunFuture(Topology *topology, uint64_t ticket) : topology_(topology), ticket_(ticket) {}
+
+  Topology *topology_{nullptr};
+  uint64_t ticket_{0};
+};
+
+inline void RunFuture::wait() const {
+  if (this->topology_ == nullptr) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(this->topology_->mutex_);
+  this->topology_->cv_.wait(lock, [this]() { return this->topology_->num_finished_ >= this->ticket_; });
+}
+
+inline bool RunFuture::ready() const {
+  if (this->topology_ == nullptr) {
+    return true;
+  }
+  std::lock_guard<std::mutex> lock(this->topology_->mutex_);
+  return this->topology_->num_finished_ >= this->ticket_;
+}
+
+}  // namespace shanzhai_tf
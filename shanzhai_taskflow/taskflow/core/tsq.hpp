@@ -0,0 +1,256 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#include "taskflow/core/cache_line.hpp"
+
+namespace shanzhai_tf {
+
+/*
+Chase-Lev工作窃取队列，只存放裸指针，Push/Pop/Steal不分配内存
+（1）所属线程调用Push、Pop，操作bottom_
+（2）其他线程调用Steal，从top_窃取
+（3）Pop和Steal竞争最后一个元素时通过CAS top_决出胜者
+（4）队列为空或竞争失败时Pop、Steal返回nullptr
+（5）Empty、Size只是瞬时值，只能作为提示
+*/
+
+// 固定容量，队列满时TryPush返回false，由调用方另行处理
+template <typename T, size_t LogSize = 10>
+class BoundedTaskQueue {
+  static_assert(std::is_pointer_v<T>, "BoundedTaskQueue stores raw pointers");
+
+  static constexpr int64_t kCapacity = int64_t{1} << LogSize;
+  static constexpr int64_t kMask = kCapacity - 1;
+
+ public:
+  bool TryPush(T item);
+  T Pop();
+  T Steal();
+  bool Empty() const;
+  size_t Size() const;
+  constexpr size_t Capacity() const { return static_cast<size_t>(kCapacity); }
+
+ private:
+  alignas(kCacheLineSize) std::atomic<int64_t> top_{0};
+  alignas(kCacheLineSize) std::atomic<int64_t> bottom_{0};
+  alignas(kCacheLineSize) std::atomic<T> buffer_[kCapacity];
+};
+
+template <typename T, size_t LogSize>
+bool BoundedTaskQueue<T, LogSize>::TryPush(T item) {
+  int64_t b = this->bottom_.load(std::memory_order_relaxed);
+  int64_t t = this->top_.load(std::memory_order_acquire);
+  if (b - t >= kCapacity) {
+    return false;
+  }
+  this->buffer_[b & kMask].store(item, std::memory_order_relaxed);
+  this->bottom_.store(b + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T, size_t LogSize>
+T BoundedTaskQueue<T, LogSize>::Pop() {
+  int64_t b = this->bottom_.load(std::memory_order_relaxed) - 1;
+  this->bottom_.store(b, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int64_t t = this->top_.load(std::memory_order_relaxed);
+
+  T item = nullptr;
+  if (t <= b) {
+    item = this->buffer_[b & kMask].load(std::memory_order_relaxed);
+    if (t == b) {
+      // 最后一个元素，和Steal竞争
+      if (!this->top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        item = nullptr;
+      }
+      this->bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+  } else {
+    this->bottom_.store(b + 1, std::memory_order_relaxed);
+  }
+  return item;
+}
+
+template <typename T, size_t LogSize>
+T BoundedTaskQueue<T, LogSize>::Steal() {
+  int64_t t = this->top_.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int64_t b = this->bottom_.load(std::memory_order_acquire);
+
+  T item = nullptr;
+  if (t < b) {
+    item = this->buffer_[t & kMask].load(std::memory_order_relaxed);
+    if (!this->top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      return nullptr;
+    }
+  }
+  return item;
+}
+
+template <typename T, size_t LogSize>
+bool BoundedTaskQueue<T, LogSize>::Empty() const {
+  int64_t b = this->bottom_.load(std::memory_order_relaxed);
+  int64_t t = this->top_.load(std::memory_order_relaxed);
+  return b <= t;
+}
+
+template <typename T, size_t LogSize>
+size_t BoundedTaskQueue<T, LogSize>::Size() const {
+  int64_t b = this->bottom_.load(std::memory_order_relaxed);
+  int64_t t = this->top_.load(std::memory_order_relaxed);
+  return static_cast<size_t>(b >= t ? b - t : 0);
+}
+
+/*
+容量不限，队列满时Push把数组扩容一倍
+旧数组可能仍被正在Steal的线程读取，所以放入garbage_，等队列析构时统一释放（延迟回收），
+扩容次数为log(最大长度)，额外内存不超过当前数组大小
+*/
+template <typename T>
+class UnboundedTaskQueue {
+  static_assert(std::is_pointer_v<T>, "UnboundedTaskQueue stores raw pointers");
+
+  struct Array {
+    int64_t capacity_;
+    int64_t mask_;
+    std::atomic<T> *data_;
+
+    explicit Array(int64_t capacity) : capacity_(capacity), mask_(capacity - 1), data_(new std::atomic<T>[capacity]) {}
+    ~Array() { delete[] this->data_; }
+
+    void Put(int64_t i, T item) { this->data_[i & this->mask_].store(item, std::memory_order_relaxed); }
+    T Get(int64_t i) { return this->data_[i & this->mask_].load(std::memory_order_relaxed); }
+
+    Array *Resize(int64_t b, int64_t t) {
+      Array *array = new Array(this->capacity_ * 2);
+      for (int64_t i = t; i != b; i++) {
+        array->Put(i, this->Get(i));
+      }
+      return array;
+    }
+  };
+
+ public:
+  explicit UnboundedTaskQueue(int64_t log_size = 10);
+  ~UnboundedTaskQueue();
+
+  UnboundedTaskQueue(const UnboundedTaskQueue &) = delete;
+  UnboundedTaskQueue &operator=(const UnboundedTaskQueue &) = delete;
+
+  void Push(T item);
+  T Pop();
+  T Steal();
+  bool Empty() const;
+  size_t Size() const;
+  size_t Capacity() const;
+
+ private:
+  alignas(kCacheLineSize) std::atomic<int64_t> top_{0};
+  alignas(kCacheLineSize) std::atomic<int64_t> bottom_{0};
+  std::atomic<Array *> array_{nullptr};
+  std::vector<Array *> garbage_{};
+};
+
+template <typename T>
+UnboundedTaskQueue<T>::UnboundedTaskQueue(int64_t log_size) {
+  this->array_.store(new Array(int64_t{1} << log_size), std::memory_order_relaxed);
+  this->garbage_.reserve(32);
+}
+
+template <typename T>
+UnboundedTaskQueue<T>::~UnboundedTaskQueue() {
+  for (auto a : this->garbage_) {
+    delete a;
+  }
+  delete this->array_.load(std::memory_order_relaxed);
+}
+
+template <typename T>
+void UnboundedTaskQueue<T>::Push(T item) {
+  int64_t b = this->bottom_.load(std::memory_order_relaxed);
+  int64_t t = this->top_.load(std::memory_order_acquire);
+  Array *a = this->array_.load(std::memory_order_relaxed);
+
+  if (a->capacity_ - 1 < b - t) {
+    Array *tmp = a->Resize(b, t);
+    this->garbage_.push_back(a);
+    a = tmp;
+    this->array_.store(a, std::memory_order_release);
+  }
+
+  a->Put(b, item);
+  this->bottom_.store(b + 1, std::memory_order_release);
+}
+
+template <typename T>
+T UnboundedTaskQueue<T>::Pop() {
+  int64_t b = this->bottom_.load(std::memory_order_relaxed) - 1;
+  Array *a = this->array_.load(std::memory_order_relaxed);
+  this->bottom_.store(b, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int64_t t = this->top_.load(std::memory_order_relaxed);
+
+  T item = nullptr;
+  if (t <= b) {
+    item = a->Get(b);
+    if (t == b) {
+      // 最后一个元素，和Steal竞争
+      if (!this->top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        item = nullptr;
+      }
+      this->bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+  } else {
+    this->bottom_.store(b + 1, std::memory_order_relaxed);
+  }
+  return item;
+}
+
+template <typename T>
+T UnboundedTaskQueue<T>::Steal() {
+  int64_t t = this->top_.load(std::memory_order_acquire);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  int64_t b = this->bottom_.load(std::memory_order_acquire);
+
+  T item = nullptr;
+  if (t < b) {
+    Array *a = this->array_.load(std::memory_order_acquire);
+    item = a->Get(t);
+    if (!this->top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+      return nullptr;
+    }
+  }
+  return item;
+}
+
+template <typename T>
+bool UnboundedTaskQueue<T>::Empty() const {
+  int64_t b = this->bottom_.load(std::memory_order_relaxed);
+  int64_t t = this->top_.load(std::memory_order_relaxed);
+  return b <= t;
+}
+
+template <typename T>
+size_t UnboundedTaskQueue<T>::Size() const {
+  int64_t b = this->bottom_.load(std::memory_order_relaxed);
+  int64_t t = this->top_.load(std::memory_order_relaxed);
+  return static_cast<size_t>(b >= t ? b - t : 0);
+}
+
+template <typename T>
+size_t UnboundedTaskQueue<T>::Capacity() const {
+  return static_cast<size_t>(this->array_.load(std::memory_order_relaxed)->capacity_);
+}
+
+}  // namespace shanzhai_tf
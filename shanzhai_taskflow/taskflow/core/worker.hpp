@@ -0,0 +1,152 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "taskflow/core/numa.hpp"
+
+namespace shanzhai_tf {
+
+/*
+Worker线程到cpu的映射策略，作为Executor构造函数的参数
+（1）numa：默认策略，第i个Worker分配到第i * K / N个NUMA节点，存在多个节点时绑定到节点的所有cpu，
+   只有一个节点时不绑核
+（2）compact：按节点顺序排列所有可用cpu，第i个Worker绑定到其中第i个，编号相邻的Worker位于同一节点
+（3）scatter：轮流从每个节点取一个cpu排列，编号相邻的Worker分散到不同节点
+（4）cpus：第i个Worker绑定到cpus[i % cpus.size()]
+（5）none：不绑核，所有Worker属于ShardedNotifier的同一个分片
+   Worker数量超过cpu数量时循环使用；绑核的Worker属于所绑定cpu所在节点的分片，
+   NumaTopology读不到节点的cpu时compact与scatter使用sched_getaffinity允许的cpu
+*/
+class WorkerAffinity {
+  friend class Executor;
+
+ public:
+  static WorkerAffinity none() { return WorkerAffinity(Policy::NONE); }
+  static WorkerAffinity numa() { return WorkerAffinity(Policy::NUMA); }
+  static WorkerAffinity compact() { return WorkerAffinity(Policy::COMPACT); }
+  static WorkerAffinity scatter() { return WorkerAffinity(Policy::SCATTER); }
+  // cpus为空或者包含负数时抛出std::invalid_argument
+  static WorkerAffinity cpus(std::vector<int> cpus);
+
+ private:
+  enum class Policy : uint8_t {
+    NONE,
+    NUMA,
+    COMPACT,
+    SCATTER,
+    EXPLICIT,
+  };
+
+  explicit WorkerAffinity(Policy policy, std::vector<int> cpus = {}) : policy_(policy), cpus_(std::move(cpus)) {}
+
+  // 第i个元素为第i个Worker绑定的cpu，为空表示不绑核
+  std::vector<std::vector<int>> Assign(const NumaTopology &numa, size_t N) const;
+
+  // interleave为false时按节点依次排列，为true时轮流从每个节点取一个
+  static std::vector<int> OrderCpus(const NumaTopology &numa, bool interleave);
+
+  Policy policy_;
+  std::vector<int> cpus_;
+};
+
+/*
+Worker线程的启动与退出回调，通过Executor构造函数传入
+（1）scheduler_prologue在Worker线程中调用，此时已经按照WorkerAffinity绑核，Worker的本地队列还没有分配，
+   可以设置线程名、重新绑核（pthread_setaffinity_np）、初始化线程局部的分配器、提高调度优先级；
+   Executor的构造函数在所有Worker的prologue返回之后才返回
+（2）scheduler_epilogue在Worker退出调度循环之后调用，之后这个线程不会再执行任务
+（3）不同Worker的回调并发执行；回调抛出的异常会导致std::terminate
+*/
+class WorkerInterface {
+ public:
+  virtual ~WorkerInterface() = default;
+
+  // cpus为WorkerAffinity分配给这个Worker的cpu，为空表示没有绑核
+  virtual void scheduler_prologue(size_t worker_id, const std::vector<int> &cpus) = 0;
+  virtual void scheduler_epilogue(size_t) {}
+};
+
+template <typename T, typename... ArgsT>
+std::shared_ptr<T> make_worker_interface(ArgsT &&...args) {
+  static_assert(std::is_base_of_v<WorkerInterface, T>, "T must derive from WorkerInterface");
+  return std::make_shared<T>(std::forward<ArgsT>(args)...);
+}
+
+inline WorkerAffinity WorkerAffinity::cpus(std::vector<int> cpus) {
+  if (cpus.empty()) {
+    throw std::invalid_argument("WorkerAffinity::cpus: empty cpu list");
+  }
+  for (int cpu : cpus) {
+    if (cpu < 0) {
+      throw std::invalid_argument("WorkerAffinity::cpus: negative cpu");
+    }
+  }
+  return WorkerAffinity(Policy::EXPLICIT, std::move(cpus));
+}
+
+inline std::vector<std::vector<int>> WorkerAffinity::Assign(const NumaTopology &numa, size_t N) const {
+  std::vector<std::vector<int>> assigned(N);
+  const size_t num_nodes = numa.NumNodes();
+  switch (this->policy_) {
+    case Policy::NONE:
+      break;
+    case Policy::NUMA:
+      if (num_nodes > 1) {
+        for (size_t i = 0; i < N; i++) {
+          assigned[i] = numa.GetNode(i * num_nodes / N).cpus_;
+        }
+      }
+      break;
+    case Policy::COMPACT:
+    case Policy::SCATTER: {
+      std::vector<int> order = OrderCpus(numa, this->policy_ == Policy::SCATTER);
+      for (size_t i = 0; i < N && !order.empty(); i++) {
+        assigned[i] = {order[i % order.size()]};
+      }
+      break;
+    }
+    case Policy::EXPLICIT:
+      for (size_t i = 0; i < N; i++) {
+        assigned[i] = {this->cpus_[i % this->cpus_.size()]};
+      }
+      break;
+  }
+  return assigned;
+}
+
+inline std::vector<int> WorkerAffinity::OrderCpus(const NumaTopology &numa, bool interleave) {
+  std::vector<int> order;
+  const size_t num_nodes = numa.NumNodes();
+  if (!interleave) {
+    for (size_t node = 0; node < num_nodes; node++) {
+      const auto &cpus = numa.GetNode(node).cpus_;
+      order.insert(order.end(), cpus.begin(), cpus.end());
+    }
+  } else {
+    for (size_t k = 0, added = 1; added > 0; k++) {
+      added = 0;
+      for (size_t node = 0; node < num_nodes; node++) {
+        const auto &cpus = numa.GetNode(node).cpus_;
+        if (k < cpus.size()) {
+          order.push_back(cpus[k]);
+          added++;
+        }
+      }
+    }
+  }
+  return order.empty() ? NumaTopology::AllowedCpus() : order;
+}
+
+}  // namespace shanzhai_tf
@@ -0,0 +1,19 @@
+/*
+ * Copyright 2024. All rights reserved.
+ * Author: hsuloong@outlook.com
+ * Created on: 2026.10.14
+ */
+
+#pragma once
+
+#include "taskflow/algorithm/for_each.hpp"
+#include "taskflow/algorithm/partitioner.hpp"
+#include "taskflow/algorithm/pipeline.hpp"
+#include "taskflow/algorithm/reduce.hpp"
+#include "taskflow/algorithm/scan.hpp"
+#include "taskflow/algorithm/sort.hpp"
+#include "taskflow/algorithm/transform.hpp"
+#include "taskflow/core/coroutine.hpp"
+#include "taskflow/core/executor.hpp"
+#include "taskflow/core/task.hpp"
+#include "taskflow/core/taskflow.hpp"